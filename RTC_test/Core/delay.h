@@ -16,7 +16,29 @@
 	******************************************************************************
 	*/
 #define DWT_DELAY_ENABLE
-//#define SYSTICK_DELAY_ENABLE
+#define SYSTICK_DELAY_ENABLE
+#define ASYNC_DELAY_ENABLE
+
+/**
+	******************************************************************************
+	*			 
+	******************************************************************************
+	*     (),  
+	*     :  SystemCoreClock  
+	*   ,  delaySimple_us   
+	*     delayLoop.   
+	*  ,    .
+	*/
+#define DELAY_CORE_CLOCK_HZ	72000000UL
+
+#ifdef DELAY_CORE_CLOCK_HZ
+#define DELAY_CYCLES_PER_US	(DELAY_CORE_CLOCK_HZ / 1000000UL)	//    1
+#define DELAY_CYCLES_PER_MS	(DELAY_CORE_CLOCK_HZ / 1000UL)		//    1
+#else
+#define DELAY_CYCLES_PER_US	(SystemCoreClock / 1000000)			//    1
+#define DELAY_CYCLES_PER_MS	(SystemCoreClock / 1000)				//    1
+#endif
+
 /**
 	******************************************************************************
 	*			    DWT (Data Watchpoint and Trace)
@@ -38,6 +60,19 @@ uint8_t delayDWT_nb_us(uint32_t, uint32_t);	// 
 uint8_t delayDWT_nb_ms(uint32_t, uint32_t);	//  
 																						//  
 
+uint64_t getDWTCount64(void);					// 64-   ( )
+
+void DWTExtend_Update(void);					//   CYCCNT (  )
+
+uint64_t DWTCyclesTo_ns(uint64_t);		//    
+
+uint64_t DWTCyclesTo_us(uint64_t);		//    
+
+uint64_t DWTCyclesTo_ms(uint64_t);		//    
+
+uint8_t delayDWT_nb64_ms(uint64_t, uint32_t);	//    
+																							//  64- 
+
 /*
 //       :
 DWTDelay_Init();
@@ -88,10 +123,14 @@ void SysTick_Handler(void);						// 
 
 uint32_t getSysTickCountDelay(void);	//    
 
+uint32_t getSysTickTimestamp_us(void);	//     (countDelay + SysTick->VAL)
+
 void delaySysTick_ms(uint32_t);				//    
 
 uint8_t delaySysTick_nb_ms(uint32_t, uint32_t);	//  
 																								//    SysTick
+
+void delaySysTick_Sleep(uint32_t);		//    SysTick (   )
 /*
 //       :
 SysTickDelay_Init();
@@ -126,13 +165,70 @@ while (1) {
 
 #endif /* SYSTICK_DELAY_ENABLE */
 
+/**
+	******************************************************************************
+	*				      TIM2
+	******************************************************************************
+	*/
+#ifdef ASYNC_DELAY_ENABLE
+
+#define ASYNC_DELAY_POOL_SIZE			8			//    
+#define ASYNC_DELAY_IRQ_PRIORITY	0x02	//   TIM2
+#define ASYNC_DELAY_NONE					0xFF	//    /  
+
+/*    (   TIM2) */
+typedef void (*DelayCallback)(void *ctx);
+
+/*   */
+void AsyncDelay_Init(void);						//  TIM2 (1 )
+
+uint8_t delayAsync_us(uint32_t, DelayCallback, void *);	//     
+
+uint8_t delayAsync_Cancel(uint8_t);		//  
+
+void TIM2_IRQHandler(void);						//   TIM2
+
+/*
+//  :     
+static void strobeDone(void *ctx) {
+	GPIOB->BRR = GPIO_BRR_BR0;			//  
+}
+
+AsyncDelay_Init();
+GPIOB->BSRR = GPIO_BSRR_BS0;			//  
+delayAsync_us(500, strobeDone, 0);	//    
+*/
+
+#endif /* ASYNC_DELAY_ENABLE */
+
 
 /**
 	******************************************************************************
 	*													   
 	******************************************************************************
 	*/
+#define DELAY_LOOP_CYCLES		3			//    delayLoop (SUBS + BHI),
+																//    DWT
+#define DELAY_LOOP_OVERHEAD	6			//      delayLoop
+
+void delayLoop(uint32_t);				//     
+
+#ifdef DELAY_CORE_CLOCK_HZ
+/**
+	* @brief	     
+	* @note		     
+	*					 ,  1-2    
+	*					  (  )
+	* @param	us	 
+	* @retval None
+	*/
+__STATIC_INLINE void delaySimple_us(uint32_t us) {
+	uint32_t cycles = us * DELAY_CYCLES_PER_US;
+	delayLoop((cycles > DELAY_LOOP_OVERHEAD) ? (cycles - DELAY_LOOP_OVERHEAD) / DELAY_LOOP_CYCLES : 0);
+}
+#else
 void delaySimple_us(uint32_t);	//    
+#endif
 
 
 #endif /* DELAY_H_ */
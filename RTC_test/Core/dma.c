@@ -0,0 +1,143 @@
+/**
+	******************************************************************************
+	* @file			dma.c
+	* @brief		     DMA1
+	*
+	*   DMA   uart_dma_uart1 (DMA_Init/DMA_Config)
+	*    DMA1.      
+	* dmaChannelInit,    dmaChannelConfig.
+	*    (, , )  
+	*      .
+	******************************************************************************
+	*/
+
+#include "dma.h"
+
+/*   DMA1 */
+static DMA_Channel_TypeDef * const dmaChannels[DMA_CHANNEL_COUNT] = {
+	DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4,
+	DMA1_Channel5, DMA1_Channel6, DMA1_Channel7
+};
+
+/*    DMA1 */
+static const IRQn_Type dmaIRQn[DMA_CHANNEL_COUNT] = {
+	DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn, DMA1_Channel4_IRQn,
+	DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn
+};
+
+/*       */
+static DMACallback dmaCallbacks[DMA_CHANNEL_COUNT];
+static void *dmaContexts[DMA_CHANNEL_COUNT];
+
+static void dmaIRQHandler(uint8_t channel);
+
+/**
+	******************************************************************************
+	* @brief	  DMA1
+	* @param	channel		  (1-7)
+	* @param	ccr				   (DIR, CIRC, MINC, PINC, PSIZE, MSIZE, PL).
+	*										  CCR    , 
+	*										  DMA_CCR1_*
+	* @param	priority	    NVIC
+	* @param	callback	   (0 -  )
+	* @param	ctx				   
+	* @retval None
+	*/
+void dmaChannelInit(uint8_t channel, uint32_t ccr, uint8_t priority, DMACallback callback, void *ctx) {
+	DMA_Channel_TypeDef *ch = dmaChannels[channel - 1];
+	
+	RCC->AHBENR |= RCC_AHBENR_DMA1EN;					//   DMA1
+	
+	ch->CCR &= ~DMA_CCR1_EN;									//      
+	
+	dmaCallbacks[channel - 1] = callback;
+	dmaContexts[channel - 1] = ctx;
+	
+	if (callback) {
+		//      .
+		//         
+		ccr |= DMA_CCR1_TCIE | DMA_CCR1_TEIE;
+		if (ccr & DMA_CCR1_CIRC) {
+			ccr |= DMA_CCR1_HTIE;
+		}
+		NVIC_SetPriority(dmaIRQn[channel - 1], priority);
+		NVIC_EnableIRQ(dmaIRQn[channel - 1]);
+	}
+	ch->CCR = ccr;
+}
+
+/**
+	******************************************************************************
+	* @brief	    DMA1
+	* @param	channel		  (1-7)
+	* @param	periph		  
+	* @param	memory		   
+	* @param	count			  
+	* @retval None
+	*/
+void dmaChannelConfig(uint8_t channel, uint32_t periph, uint32_t memory, uint16_t count) {
+	DMA_Channel_TypeDef *ch = dmaChannels[channel - 1];
+	
+	ch->CCR &= ~DMA_CCR1_EN;									// CNDTR      
+	DMA1->IFCR = DMA_IFCR_CGIF1 << ((channel - 1) * 4);	//   
+	ch->CNDTR = count;												//  
+	ch->CPAR = periph;												//  
+	ch->CMAR = memory;												//  
+	ch->CCR |= DMA_CCR1_EN;										//  
+}
+
+/**
+	******************************************************************************
+	* @brief	  DMA1
+	* @param	channel		  (1-7)
+	* @retval None
+	*/
+void dmaChannelDisable(uint8_t channel) {
+	dmaChannels[channel - 1]->CCR &= ~DMA_CCR1_EN;
+	DMA1->IFCR = DMA_IFCR_CGIF1 << ((channel - 1) * 4);
+}
+
+/**
+	******************************************************************************
+	* @brief	 ,   
+	* @param	channel		  (1-7)
+	* @retval   CNDTR
+	*/
+uint16_t dmaChannelRemaining(uint8_t channel) {
+	return dmaChannels[channel - 1]->CNDTR;
+}
+
+/**
+	******************************************************************************
+	* @brief	    DMA1
+	* @param	channel		  (1-7)
+	* @retval None
+	*/
+static void dmaIRQHandler(uint8_t channel) {
+	uint8_t shift = (channel - 1) * 4;				//   n   4*(n-1)..4*(n-1)+3
+	uint32_t isr = DMA1->ISR >> shift;
+	uint8_t event = 0;
+	
+	if (isr & DMA_ISR_HTIF1) event |= DMA_EVENT_HALF;
+	if (isr & DMA_ISR_TCIF1) event |= DMA_EVENT_COMPLETE;
+	if (isr & DMA_ISR_TEIF1) {
+		//     
+		event |= DMA_EVENT_ERROR;
+	}
+	
+	//    ( 1  DMA_IFCR)
+	DMA1->IFCR = DMA_IFCR_CGIF1 << shift;
+	
+	if (event && dmaCallbacks[channel - 1]) {
+		dmaCallbacks[channel - 1](event, dmaContexts[channel - 1]);
+	}
+}
+
+/*    DMA1 */
+void DMA1_Channel1_IRQHandler(void) { dmaIRQHandler(1); }
+void DMA1_Channel2_IRQHandler(void) { dmaIRQHandler(2); }
+void DMA1_Channel3_IRQHandler(void) { dmaIRQHandler(3); }
+void DMA1_Channel4_IRQHandler(void) { dmaIRQHandler(4); }
+void DMA1_Channel5_IRQHandler(void) { dmaIRQHandler(5); }
+void DMA1_Channel6_IRQHandler(void) { dmaIRQHandler(6); }
+void DMA1_Channel7_IRQHandler(void) { dmaIRQHandler(7); }
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file			dma.h
+  * @brief		      DMA1
+  ******************************************************************************
+  */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include "stm32f10x.h"
+
+/*   DMA1 */
+#define DMA_CHANNEL_COUNT		7
+
+/*  ,    */
+#define DMA_CHANNEL_TIM3_CH3	2			//  TIM3_CH3 - DMA1 Channel 2 (  )
+#define DMA_CHANNEL_TIM3_UP		3			//  TIM3_UP - DMA1 Channel 3 (  )
+#define DMA_CHANNEL_I2C1_TX	6			//  I2C1_TX   DMA1 Channel 6
+
+/*  ,      */
+#define DMA_EVENT_HALF			0x01	//    (HTIF)
+#define DMA_EVENT_COMPLETE	0x02	//   (TCIF)
+#define DMA_EVENT_ERROR			0x04	//   (TEIF)
+
+/*       (  ) */
+typedef void (*DMACallback)(uint8_t event, void *ctx);
+
+/*   */
+void dmaChannelInit(uint8_t, uint32_t, uint8_t, DMACallback, void*);	//  
+void dmaChannelConfig(uint8_t, uint32_t, uint32_t, uint16_t);				//  
+void dmaChannelDisable(uint8_t);																		//  
+uint16_t dmaChannelRemaining(uint8_t);															//  
+void DMA1_Channel1_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void DMA1_Channel4_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+void DMA1_Channel6_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+
+#endif	/* DMA_H */
@@ -0,0 +1,150 @@
+/**
+	******************************************************************************
+	* @file			event.c
+	* @brief		      
+	*
+	*         
+	* (eventPost),    (I2C,  ) 
+	*     eventDispatch  ,   ,
+	*    .    eventIdle 
+	*   WFI   ,    
+	*     -   SysTick   .
+	*
+	*   :      
+	*  head (LDREXB/STREXB),      .
+	*        
+	*   ,      .
+	******************************************************************************
+	*/
+
+#include "event.h"
+#include "delay.h"
+
+/*  */
+typedef struct {
+	uint8_t type;											//  
+	int32_t param;										//  
+} Event;
+
+/*     */
+typedef struct {
+	Event events[EVENT_QUEUE_SIZE];		//   
+	volatile uint8_t ready[EVENT_QUEUE_SIZE];	//   
+	volatile uint8_t head;						//    ()
+	volatile uint8_t tail;						//    ( )
+} EventQueue;
+
+static EventQueue eventQueues[EVENT_PRIO_COUNT];
+static EventHandler eventHandlers[EVENT_TYPE_COUNT];
+
+/**
+	******************************************************************************
+	* @brief	   
+	* @param	type			  (EVENT_*)
+	* @param	handler		
+	* @retval None
+	*/
+void eventSetHandler(uint8_t type, EventHandler handler) {
+	if (type < EVENT_TYPE_COUNT) {
+		eventHandlers[type] = handler;
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	   
+	* @param	prio		 (EVENT_PRIO_*)
+	* @param	type		  (EVENT_*)
+	* @param	param		 
+	* @retval 1 -  , 0 -  
+	* @note		        
+	*/
+uint8_t eventPost(uint8_t prio, uint8_t type, int32_t param) {
+	EventQueue *q = &eventQueues[prio];
+	uint8_t head;
+	
+	//  :    LDREXB  STREXB
+	// (      )
+	// STREXB  1   
+	do {
+		head = __LDREXB(&q->head);
+		if ((uint8_t)(head - q->tail) >= EVENT_QUEUE_SIZE) {
+			__CLREX();
+			return 0;														//  
+		}
+	} while (__STREXB(head + 1, &q->head));
+	
+	uint8_t slot = head & (EVENT_QUEUE_SIZE - 1);
+	q->events[slot].type = type;
+	q->events[slot].param = param;
+	__DMB();																//      
+	q->ready[slot] = 1;
+	return 1;
+}
+
+/**
+	******************************************************************************
+	* @brief	    
+	* @param	None
+	* @retval 1 -  , 0 -  
+	*/
+uint8_t eventPending(void) {
+	for (uint8_t prio = 0; prio < EVENT_PRIO_COUNT; prio++) {
+		if (eventQueues[prio].head != eventQueues[prio].tail) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @param	None
+	* @retval 1 -  , 0 -  
+	* @note		    
+	*/
+uint8_t eventDispatch(void) {
+	for (uint8_t prio = 0; prio < EVENT_PRIO_COUNT; prio++) {
+		EventQueue *q = &eventQueues[prio];
+		uint8_t slot = q->tail & (EVENT_QUEUE_SIZE - 1);
+		
+		//         
+		if (q->tail == q->head || !q->ready[slot]) {
+			continue;
+		}
+		
+		Event event = q->events[slot];
+		q->ready[slot] = 0;
+		__DMB();															//     
+		q->tail++;
+		
+		if (eventHandlers[event.type]) {
+			eventHandlers[event.type](event.param);
+		}
+		return 1;
+	}
+	return 0;
+}
+
+/**
+	******************************************************************************
+	* @brief	     ,   
+	* @param	wakeTick	 SysTick,     ( )
+	* @retval None
+	* @note		   WFI    :
+	*					,   ,   
+	*					   ,     .
+	*					       
+	*					,     
+	*/
+void eventIdle(uint32_t wakeTick) {
+	__disable_irq();
+	if (!eventPending()) {
+		int32_t sleep = (int32_t)(wakeTick - getSysTickCountDelay());
+		if (sleep > 0) {
+			delaySysTick_Sleep((uint32_t)sleep);
+		}
+	}
+	__enable_irq();
+}
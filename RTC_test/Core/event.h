@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file			event.h
+  * @brief		    
+  ******************************************************************************
+  */
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include "stm32f10x.h"
+
+/*   (0 - ) */
+#define EVENT_PRIO_HIGH				0
+#define EVENT_PRIO_NORMAL			1
+#define EVENT_PRIO_LOW				2
+#define EVENT_PRIO_COUNT			3
+
+/*     ( ,   128) */
+#define EVENT_QUEUE_SIZE			8
+
+/*   */
+#define EVENT_KEY							0			//     
+#define EVENT_SCHEDULER_CHECK	1			//  
+#define EVENT_RTC_SECOND			2			//   RTC ( )
+#define EVENT_TYPE_COUNT			3
+
+/*   (     ) */
+typedef void (*EventHandler)(int32_t param);
+
+/*   */
+void eventSetHandler(uint8_t, EventHandler);	//    
+uint8_t eventPost(uint8_t, uint8_t, int32_t);	//     ( ..  )
+uint8_t eventPending(void);										//   
+uint8_t eventDispatch(void);									//   
+void eventIdle(uint32_t);											//         
+
+#endif	/* EVENT_H */
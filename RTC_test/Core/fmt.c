@@ -0,0 +1,101 @@
+/**
+	******************************************************************************
+	* @file			fmt.c
+	* @brief		     
+	*
+	*  sprintf    :    
+	*     ( ..    LCD)  
+	*    .      
+	*  -,  printf    .
+	******************************************************************************
+	*/
+
+#include "fmt.h"
+
+/**
+	******************************************************************************
+	* @brief	      
+	* @param	dst		 (  width )
+	* @param	value	
+	* @param	width	 
+	* @retval	    
+	* @note		 ,    width, 
+	******************************************************************************
+	*/
+char* fmtUint(char *dst, uint32_t value, uint8_t width) {
+	char *end = dst + width;
+	char *p = end;
+	
+	//    ,    - 
+	while (p > dst) {
+		*--p = (char)('0' + value % 10);
+		value /= 10;
+	}
+	return end;
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @param	dst		 (  width )
+	* @param	str		
+	* @param	width	 
+	* @retval	    
+	* @note		  ,   
+	******************************************************************************
+	*/
+char* fmtStr(char *dst, const char *str, uint8_t width) {
+	char *end = dst + width;
+	
+	while (dst < end && *str) {
+		*dst++ = *str++;
+	}
+	while (dst < end) {
+		*dst++ = ' ';
+	}
+	return end;
+}
+
+/**
+	******************************************************************************
+	* @brief	  ("ON "  "OFF")
+	* @param	dst		 (  FMT_ONOFF_LEN )
+	* @param	on		0 - ,  
+	* @retval	    
+	******************************************************************************
+	*/
+char* fmtOnOff(char *dst, uint8_t on) {
+	return fmtStr(dst, on ? "ON" : "OFF", FMT_ONOFF_LEN);
+}
+
+/**
+	******************************************************************************
+	* @brief	   ::
+	* @param	dst		 (  FMT_TIME_LEN )
+	* @param	td		
+	* @retval	    
+	******************************************************************************
+	*/
+char* fmtTime(char *dst, const RTCTimeDate *td) {
+	dst = fmtUint(dst, td->hours, 2);
+	*dst++ = ':';
+	dst = fmtUint(dst, td->minutes, 2);
+	*dst++ = ':';
+	return fmtUint(dst, td->seconds, 2);
+}
+
+/**
+	******************************************************************************
+	* @brief	   //
+	* @param	dst		 (  FMT_DATE_LEN )
+	* @param	td		
+	* @retval	    
+	******************************************************************************
+	*/
+char* fmtDate(char *dst, const RTCTimeDate *td) {
+	dst = fmtUint(dst, td->day, 2);
+	*dst++ = '/';
+	dst = fmtUint(dst, td->month, 2);
+	*dst++ = '/';
+	return fmtUint(dst, td->year, 4);
+}
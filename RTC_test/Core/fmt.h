@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file			fmt.h
+  * @brief		       
+  ******************************************************************************
+  */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+#include "rtc.h"
+
+/*     (  ) */
+#define FMT_ONOFF_LEN		3				// "ON " / "OFF"
+#define FMT_TIME_LEN		8				// ::
+#define FMT_DATE_LEN		10			// //
+
+/*  .       
+            */
+char* fmtUint(char *, uint32_t, uint8_t);				//     
+char* fmtStr(char *, const char *, uint8_t);		// ,  
+char* fmtOnOff(char *, uint8_t);								//  "ON "/"OFF"
+char* fmtTime(char *, const RTCTimeDate *);			//  ::
+char* fmtDate(char *, const RTCTimeDate *);			//  //
+
+#endif	/* FMT_H */
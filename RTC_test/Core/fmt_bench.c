@@ -0,0 +1,126 @@
+/**
+	******************************************************************************
+	* @file			fmt_bench.c
+	* @brief		 fmt  sprintf  
+	*
+	*       (lcdUpdateTime)  
+	*  17 :  sprintf       fmt.
+	*    FMT_BENCH_RUNS   
+	* ,      DWT  
+	*    .  
+	*   (RTC_test    ).
+	*
+	*        Listings/RTC_test.map:
+	*   "Image component sizes"   _printf_*.o,
+	* __printf*.o, _sputc.o  noretval__2sprintf.o   FMT_BENCH
+	*  fmt.o   .
+	******************************************************************************
+	*/
+
+#include "fmt_bench.h"
+
+#ifdef FMT_BENCH
+
+#include "stm32f10x.h"
+#include "fmt.h"
+#include <stdio.h>
+#include <string.h>
+
+/*   -      */
+static const RTCTimeDate fmtBenchTime = {59, 59, 23, 31, 12, 2099, 7};
+
+/*  sprintf  fmt (  ) */
+static char fmtBenchBufA[17];
+static char fmtBenchBufB[17];
+
+static void fmtBenchDateSprintf(char *buf, const RTCTimeDate *td, uint8_t on);
+static void fmtBenchDateFmt(char *buf, const RTCTimeDate *td, uint8_t on);
+static void fmtBenchTimeSprintf(char *buf, const RTCTimeDate *td, uint8_t on);
+static void fmtBenchTimeFmt(char *buf, const RTCTimeDate *td, uint8_t on);
+static uint32_t fmtBenchMeasure(void (*fn)(char *, const RTCTimeDate *, uint8_t), char *buf, uint32_t overhead);
+static void fmtBenchEmpty(char *buf, const RTCTimeDate *td, uint8_t on);
+
+/**
+	******************************************************************************
+	* @brief	 fmt  sprintf
+	* @param	result	  
+	* @retval	None
+	******************************************************************************
+	*/
+void fmtBenchRun(FmtBenchResult *result) {
+	uint32_t overhead = fmtBenchMeasure(fmtBenchEmpty, fmtBenchBufA, 0);
+	
+	result->sprintfDate = fmtBenchMeasure(fmtBenchDateSprintf, fmtBenchBufA, overhead);
+	result->fmtDate = fmtBenchMeasure(fmtBenchDateFmt, fmtBenchBufB, overhead);
+	result->match = (memcmp(fmtBenchBufA, fmtBenchBufB, sizeof(fmtBenchBufA)) == 0);
+	
+	result->sprintfTime = fmtBenchMeasure(fmtBenchTimeSprintf, fmtBenchBufA, overhead);
+	result->fmtTime = fmtBenchMeasure(fmtBenchTimeFmt, fmtBenchBufB, overhead);
+	result->match &= (memcmp(fmtBenchBufA, fmtBenchBufB, sizeof(fmtBenchBufA)) == 0);
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @param	fn				
+	* @param	buf				 
+	* @param	overhead	  , 
+	* @retval	 DWT
+	******************************************************************************
+	*/
+static uint32_t fmtBenchMeasure(void (*fn)(char *, const RTCTimeDate *, uint8_t), char *buf, uint32_t overhead) {
+	uint32_t best = UINT32_MAX;
+	
+	for (uint8_t i = 0; i < FMT_BENCH_RUNS; i++) {
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		uint32_t start = DWT->CYCCNT;
+		fn(buf, &fmtBenchTime, i & 1);
+		uint32_t cycles = DWT->CYCCNT - start;
+		__set_PRIMASK(primask);
+		
+		if (cycles < best) {
+			best = cycles;
+		}
+	}
+	return (best > overhead) ? best - overhead : 0;
+}
+
+//          DWT
+static void fmtBenchEmpty(char *buf, const RTCTimeDate *td, uint8_t on) {
+	(void)buf;
+	(void)td;
+	(void)on;
+}
+
+//  :  lcdUpdateTime    fmt
+static void fmtBenchDateSprintf(char *buf, const RTCTimeDate *td, uint8_t on) {
+	sprintf(buf, "%02d/%02d/%04d% 02d %s",
+					td->day, td->month, td->year, td->weekday, on ? "ON " : "OFF");
+}
+
+//    fmt
+static void fmtBenchDateFmt(char *buf, const RTCTimeDate *td, uint8_t on) {
+	char *p = fmtDate(buf, td);
+	*p++ = ' ';
+	p = fmtUint(p, td->weekday, 1);
+	*p++ = ' ';
+	p = fmtOnOff(p, on);
+	*p = '\0';
+}
+
+//  :  lcdUpdateTime    fmt
+static void fmtBenchTimeSprintf(char *buf, const RTCTimeDate *td, uint8_t on) {
+	sprintf(buf, "%02d:%02d:%02d     %s",
+					td->hours, td->minutes, td->seconds, on ? "ON " : "OFF");
+}
+
+//    fmt
+static void fmtBenchTimeFmt(char *buf, const RTCTimeDate *td, uint8_t on) {
+	char *p = fmtTime(buf, td);
+	p = fmtStr(p, "", 5);
+	p = fmtOnOff(p, on);
+	*p = '\0';
+}
+
+#endif	/* FMT_BENCH */
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file			fmt_bench.h
+  * @brief		   fmt  sprintf  
+  ******************************************************************************
+  */
+
+#ifndef FMT_BENCH_H
+#define FMT_BENCH_H
+
+#include <stdint.h>
+
+/*  .  sprintf  , 
+	       */
+//#define FMT_BENCH
+
+#define FMT_BENCH_RUNS		32					//    ( )
+
+/*     DWT (  FMT_BENCH_RUNS) */
+typedef struct {
+	uint32_t sprintfDate;								// sprintf    
+	uint32_t fmtDate;										// fmt   
+	uint32_t sprintfTime;								// sprintf    
+	uint32_t fmtTime;										// fmt   
+	uint8_t match;											// 1 -  sprintf  fmt 
+} FmtBenchResult;
+
+/*   */
+void fmtBenchRun(FmtBenchResult *);		//  (    )
+
+#endif	/* FMT_BENCH_H */
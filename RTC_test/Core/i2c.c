@@ -7,9 +7,33 @@
 	*/
 																																	
 #include "i2c.h"
+#include "dma.h"
 #include "delay.h"
 #include "stm32f10x.h"
 
+#define I2C_STATUS_PENDING		0xFF	//    ( )
+
+static I2CTransaction i2cQueue[I2C_QUEUE_SIZE];	//   
+static volatile uint8_t i2cHead = 0;						//    
+static volatile uint8_t i2cTail = 0;						//   
+static volatile uint8_t i2cActive = 0;					//     
+static uint16_t i2cIndex = 0;										//   
+static volatile uint8_t i2cDmaMode = 0;					// :     DMA
+static volatile uint8_t i2cDmaDone = 0;					// : DMA   DR  
+static uint32_t i2cStartTick = 0;							//     (SysTick, )
+static uint32_t i2cInitTick = 0;								//   i2cInit (SysTick, )
+static uint8_t i2cReady = 0;										// :  
+
+static uint8_t i2cEnqueue(uint8_t addr, const uint8_t *data, uint8_t *rxData, uint16_t len, I2CCallback callback, void *ctx);
+static void i2cStartNext(void);
+static void i2cComplete(uint8_t status);
+static void i2cWriteNext(const I2CTransaction *t);
+static void i2cReadNext(const I2CTransaction *t);
+static uint8_t i2cAbortExpired(void);
+static void i2cSyncCallback(uint8_t status, void *ctx);
+static void i2cDmaCallback(uint8_t event, void *ctx);
+static uint32_t i2cGetPCLK1(void);
+
 /**
 	******************************************************************************
 	* @brief		  I2C1
@@ -52,148 +76,606 @@ void i2cInit(void){
 		
 	I2C1->CR1 &=~ I2C_CR1_PE;//  I2C  
 	
-	//    (  )
-	// TRISE (Time RISE maximum) = APB1_FREQ_MHz + 1 = 36 + 1 = 37
-	//      SCL (  APB1)
+	//  APB1 (PCLK1),    I2C1
+	uint32_t pclk1 = i2cGetPCLK1();
+	
+	//   
+	// TRISE (Time RISE maximum)      SCL (  APB1)
 	//   : TRISE >= (_APB1__ + 1).
 	//   : TRISE >= ((_APB1__ * 300 ) + 1)
-	I2C1->TRISE = 37;
+	I2C1->TRISE = I2C_TRISE_VALUE(pclk1);
 	
-	//   ( 36 MHz APB1)
-	I2C1->CR2 = 36;  //     APB1 ( )   .  : 250 .
+	//   APB1   ( 36 MHz APB1 - 36)
+	I2C1->CR2 = I2C_FREQ_VALUE(pclk1);  //     APB1 ( )   .  : 236 .
 	
 	// CCR  (Clock Control Register)        SCL.     (/)
-	// CCR = APB1_FREQ / (2 * I2C_FREQ)
-	//  100 kHz: CCR = 36,000,000 / (2 * 100,000) = 180
-	I2C1->CCR = 180; // CCR = 180
+	//  :			CCR = APB1_FREQ / (2 * I2C_FREQ),  100 kHz: 36,000,000 / (2 * 100,000) = 180
+	//  , DUTY 2:1:	CCR = APB1_FREQ / (3 * I2C_FREQ),  400 kHz: 36,000,000 / (3 * 400,000) = 30
+	//  , DUTY 16:9:	CCR = APB1_FREQ / (25 * I2C_FREQ),  400 kHz: 36,000,000 / (25 * 400,000) = 3.6 -> 4
+	//       F/S  DUTY (. I2C_CCR_VALUE)
+	I2C1->CCR = I2C_CCR_VALUE(pclk1);
 
 	// POS  acknowledge POSition (0  ACK    ; 1  ACK    )
 	I2C1->CR1 &= ~I2C_CR1_POS;
 	// ACK  ACKnowledge enable (1  /  ACK   . 0   NACK)
 	I2C1->CR1 |= I2C_CR1_ACK;
 
+	// ITERREN  ITERRor ENable (  : BERR, ARLO, AF, OVR)
+	//   (ITEVTEN, ITBUFEN)     
+	I2C1->CR2 |= I2C_CR2_ITERREN;
+	
+	//  DMA1 Channel 6 ( I2C1_TX):  -> ,   ,
+	// 8- ,  .      ,
+	//    I2C1,      
+	dmaChannelInit(DMA_CHANNEL_I2C1_TX, DMA_CCR1_DIR | DMA_CCR1_MINC | DMA_CCR1_PL_0,
+								 I2C_IRQ_PRIORITY, i2cDmaCallback, 0);
+
 	//  I2C
 	I2C1->CR1 |= I2C_CR1_PE;
 	
-	//   
-    delayDWT_ms(10);
+	//   I2C1  NVIC
+	NVIC_SetPriority(I2C1_EV_IRQn, I2C_IRQ_PRIORITY);
+	NVIC_SetPriority(I2C1_ER_IRQn, I2C_IRQ_PRIORITY);
+	NVIC_EnableIRQ(I2C1_EV_IRQn);
+	NVIC_EnableIRQ(I2C1_ER_IRQn);
+	
+	//    :  
+	//  I2C_STARTUP_MS    (. i2cIsReady)
+	i2cReady = 0;
+	i2cInitTick = getSysTickCountDelay();
 }
 
 /**
 	******************************************************************************
-	* @brief		    
-	* @param		data	 
-	* @param		addr	     (7-)
-	* @retval		None
+	* @brief		    
+	* @param		addr			  (7-)
+	* @param		data			  (     )
+	* @param		len				 
+	* @param		callback	     (  ),   0
+	* @param		ctx				   
+	* @retval		1 -    , 0 -  
 	******************************************************************************
 	*/
-void i2cWriteByte(uint8_t addr, uint8_t data) {
-	//   START
-	i2cStart();
-  
-	i2cWrite((addr << 1) | I2C_REQUEST_WRITE); //   ,   1  (  0x27,   0x4E)   
-	//   ADDR
-	// ADDR  SR1  Address sent.   1  / .   SR1    SR2
-	uint32_t timeout = 100000;	//    
-	while(!(I2C1->SR1 & I2C_SR1_ADDR) && timeout--) {
-		__NOP(); //     
-		};
-	if (timeout == 0) {
-		//   
-	}
-	//   ADDR c        ADDR
-	//    PRIMASK   primask
-	// __get_PRIMASK()  0,   ,  1,  
+uint8_t i2cSubmit(uint8_t addr, const uint8_t *data, uint16_t len, I2CCallback callback, void *ctx) {
+	return i2cEnqueue(addr, data, 0, len, callback, ctx);
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		addr			  (7-)
+	* @param		data			  (    )
+	* @param		len				  (  1)
+	* @param		callback	     (  ),   0
+	* @param		ctx				   
+	* @retval		1 -    , 0 -  
+	******************************************************************************
+	*/
+uint8_t i2cSubmitRead(uint8_t addr, uint8_t *data, uint16_t len, I2CCallback callback, void *ctx) {
+	return i2cEnqueue(addr, 0, data, len, callback, ctx);
+}
+
+/**
+	******************************************************************************
+	* @brief		   
+	* @param		addr			  (7-)
+	* @param		data			  ()
+	* @param		rxData		  (), 0 -  
+	* @param		len				 
+	* @param		callback	    ,   0
+	* @param		ctx				   
+	* @retval		1 -    , 0 -  
+	******************************************************************************
+	*/
+static uint8_t i2cEnqueue(uint8_t addr, const uint8_t *data, uint8_t *rxData, uint16_t len, I2CCallback callback, void *ctx) {
+	//       ,    ,
+	//        
 	uint32_t primask = __get_PRIMASK();
 	__disable_irq();	//  
 	
-	(void)I2C1->SR1;  //  SR1 -     ADDR
-	(void)I2C1->SR2;  //  SR2 -     ADDR
+	uint8_t next = (i2cHead + 1) & (I2C_QUEUE_SIZE - 1);
+	if (next == i2cTail) {
+		//  
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	
+	I2CTransaction *t = &i2cQueue[i2cHead];
+	t->addr = addr;
+	t->data = data;
+	t->rxData = rxData;
+	t->len = len;
+	t->callback = callback;
+	t->ctx = ctx;
+	i2cHead = next;
+	
+	//    -   
+	if (!i2cActive) {
+		i2cStartNext();
+	}
 	
-	//    PRIMASK   primask
-	// __set_PRIMASK(1)  __disable_irq()
-	// __set_PRIMASK(0)  __enable_irq()
 	__set_PRIMASK(primask);
+	return 1;
+}
 
-	//  (data);
-	i2cWrite(data);
-	//   
-	// BTF  SR1  ByteTransferFinished.
-	//  1     DR    .
-	//   SR1,  / DR
-	timeout = 100000;	//    
-	while (!(I2C1->SR1 & I2C_SR1_BTF) && timeout--) {
-		__NOP(); //     
-		};
-	if (timeout == 0) {
-		//   
+/**
+	******************************************************************************
+	* @brief		   
+	* @param		None
+	* @retval		1 -       , 0 -  
+	******************************************************************************
+	*/
+uint8_t i2cIsBusy(void) {
+	return i2cActive || (i2cHead != i2cTail);
+}
+
+/**
+	******************************************************************************
+	* @brief		     
+	* @param		None
+	* @retval		1 -   i2cInit    I2C_STARTUP_MS, 0 - 
+	******************************************************************************
+	*/
+uint8_t i2cIsReady(void) {
+	//   ,      .
+	//   SysTick: CYCCNT  ,    
+	if (!i2cReady && delaySysTick_nb_ms(i2cInitTick, I2C_STARTUP_MS + 1)) {
+		i2cReady = 1;
 	}
+	return i2cReady;
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		op		 
+	* @param		addr	  (7-)
+	* @param		data	  (     )
+	* @param		len		 
+	* @retval		None
+	******************************************************************************
+	*/
+void i2cWriteOpInit(I2COp *op, uint8_t addr, const uint8_t *data, uint16_t len) {
+	PT_INIT(&op->pt);
+	op->addr = addr;
+	op->data = data;
+	op->rxData = 0;
+	op->len = len;
+	op->status = I2C_STATUS_PENDING;
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		op		 
+	* @param		addr	  (7-)
+	* @param		data	  (  )
+	* @retval		None
+	******************************************************************************
+	*/
+void i2cWriteByteOpInit(I2COp *op, uint8_t addr, uint8_t data) {
+	op->byte = data;
+	i2cWriteOpInit(op, addr, &op->byte, 1);
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		op		 
+	* @param		addr	  (7-)
+	* @param		data	  (    )
+	* @param		len		  (  1)
+	* @retval		None
+	******************************************************************************
+	*/
+void i2cReadOpInit(I2COp *op, uint8_t addr, uint8_t *data, uint16_t len) {
+	i2cWriteOpInit(op, addr, 0, len);
+	op->rxData = data;
+}
+
+/**
+	******************************************************************************
+	* @brief		 :       
+	* @param		op		  ( i2cWriteOpInit/i2cWriteByteOpInit/i2cReadOpInit)
+	* @retval		PT_WAITING -  , PT_ENDED -  (  op->status)
+	* @note			    ,  
+	*						 I2C_TIMEOUT_MS (     )
+	******************************************************************************
+	*/
+PT_THREAD(i2cTransferThread(I2COp *op)) {
+	PT_BEGIN(&op->pt);
+	
+	PT_WAIT_UNTIL(&op->pt, i2cIsReady());
 	
-	//   STOP
-	i2cStop();
+	//    (     ).
+	//      ,    
+	op->status = I2C_STATUS_PENDING;
+	PT_WAIT_UNTIL(&op->pt, i2cEnqueue(op->addr, op->data, op->rxData, op->len, i2cSyncCallback, (void*)&op->status));
 	
-	//   
-    delayDWT_us(15);
+	//   .
+	//   STOP  :  START  
+	//   STOP   (. i2cStartNext)
+	//     ,      ,
+	//   
+	while (op->status == I2C_STATUS_PENDING) {
+		PT_WAIT_UNTIL(&op->pt, op->status != I2C_STATUS_PENDING || i2cAbortExpired());
+	}
+	
+	PT_END(&op->pt);
+}
+
+/**
+	******************************************************************************
+	* @brief		     (   )
+	* @param		addr	     (7-)
+	* @param		data	 
+	* @retval		None
+	******************************************************************************
+	*/
+void i2cWriteByte(uint8_t addr, uint8_t data) {
+	I2COp op;
+	i2cWriteByteOpInit(&op, addr, data);
+	while (PT_SCHEDULE(i2cTransferThread(&op))) {
+		__NOP();
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		         START..STOP
+	* @param		addr	     (7-)
+	* @param		data	 
+	* @param		len		 
+	* @retval		None
+	* @note			  .    
+	*						     I2C_IRQ_PRIORITY
+	******************************************************************************
+	*/
+void i2cWriteBuffer(uint8_t addr, const uint8_t *data, uint16_t len) {
+	I2COp op;
+	i2cWriteOpInit(&op, addr, data, len);
+	//       ,
+	//       
+	while (PT_SCHEDULE(i2cTransferThread(&op))) {
+		__NOP();
+	}
 }
 
 /**
 	******************************************************************************
-	* @brief		  START
+	* @brief		         START..STOP
+	* @param		addr	  (7-)
+	* @param		data	 
+	* @param		len		  (  1)
+	* @retval		  (I2C_STATUS_*)
+	* @note			  .    
+	*						     I2C_IRQ_PRIORITY
+	******************************************************************************
+	*/
+uint8_t i2cReadBuffer(uint8_t addr, uint8_t *data, uint16_t len) {
+	I2COp op;
+	i2cReadOpInit(&op, addr, data, len);
+	while (PT_SCHEDULE(i2cTransferThread(&op))) {
+		__NOP();
+	}
+	return op.status;
+}
+
+/**
+	******************************************************************************
+	* @brief		   I2C1
 	* @param		None
 	* @retval		None
 	******************************************************************************
 	*/
-void i2cStart(void) {
-	//   1    START  .     
-	I2C1->CR1 |= I2C_CR1_START;
-	//   SB (StartBit)   SR1 (StatusRegister1)
-	//   1     START.   SR1     DR
-	uint32_t timeout = 100000;	//    
-	while (!(I2C1->SR1 & I2C_SR1_SB) && timeout--){
-	__NOP(); //     
-		};
-	if (timeout == 0) {
-		//   
+void I2C1_EV_IRQHandler(void) {
+	uint16_t sr1 = I2C1->SR1;	//  SR1 -     SB  ADDR
+	I2CTransaction *t = &i2cQueue[i2cTail];
+	
+	if (!i2cActive) {
+		//    -   
+		I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN);
+		return;
+	}
+	
+	// EV5: SB -  START ,     .
+	//   DR    SB
+	if (sr1 & I2C_SR1_SB) {
+		I2C1->DR = (t->addr << 1) | (t->rxData ? I2C_REQUEST_READ : I2C_REQUEST_WRITE);
+		return;
+	}
+	
+	if (t->rxData) {
+		if (sr1 & I2C_SR1_ADDR) {
+			if (t->len == 1) {
+				// EV6_1:   - NACK    ADDR,
+				// STOP -  ,      
+				I2C1->CR1 &= ~I2C_CR1_ACK;
+				(void)I2C1->SR2;
+				I2C1->CR1 |= I2C_CR1_STOP;
+			} else if (t->len == 2) {
+				//   (RM0008):   ADDR - POS = 1  ACK = 0,
+				//  NACK    .   
+				//  BTF (  DR,    , SCL ),
+				//   RXNE  
+				I2C1->CR1 |= I2C_CR1_POS;
+				I2C1->CR1 &= ~I2C_CR1_ACK;
+				(void)I2C1->SR2;
+				I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
+			} else {
+				(void)I2C1->SR2;
+			}
+			return;
+		}
+		if (t->len == 2) {
+			if (sr1 & I2C_SR1_BTF) {
+				I2C1->CR1 |= I2C_CR1_STOP;
+				t->rxData[0] = (uint8_t)I2C1->DR;
+				t->rxData[1] = (uint8_t)I2C1->DR;
+				i2cIndex = 2;
+				i2cComplete(I2C_STATUS_OK);
+			}
+			return;
+		}
+		// EV7:  
+		if (sr1 & I2C_SR1_RXNE) {
+			i2cReadNext(t);
+		}
+		return;
+	}
+	
+	// EV6: ADDR -    .  SR2    ADDR
+	if (sr1 & I2C_SR1_ADDR) {
+		(void)I2C1->SR2;
+		if (t->len == 0) {
+			//    (  )
+			I2C1->CR1 |= I2C_CR1_STOP;
+			i2cComplete(I2C_STATUS_OK);
+			return;
+		}
+		if (i2cDmaMode) {
+			//   DMA   TXE
+			return;
+		}
+		// EV8_1:    
+		i2cWriteNext(t);
+		return;
+	}
+	
+	if (i2cDmaMode) {
+		// EV8_2   DMA:   DMA  BTF   STOP
+		if ((sr1 & I2C_SR1_BTF) && i2cDmaDone) {
+			I2C1->CR1 |= I2C_CR1_STOP;
+			i2cComplete(I2C_STATUS_OK);
+		}
+		return;
+	}
+	
+	if (sr1 & I2C_SR1_TXE) {
+		if (i2cIndex < t->len) {
+			// EV8: DR  -   
+			i2cWriteNext(t);
+		} else if (sr1 & I2C_SR1_BTF) {
+			// EV8_2:    -   STOP
+			I2C1->CR1 |= I2C_CR1_STOP;
+			i2cComplete(I2C_STATUS_OK);
+		}
 	}
 }
 
 /**
 	******************************************************************************
-	* @brief		  STOP
+	* @brief		   I2C1
 	* @param		None
 	* @retval		None
 	******************************************************************************
 	*/
-void i2cStop(void) {
-	//  STOP
-	I2C1->CR1 |= I2C_CR1_STOP;
-	//  .
-	// STOP  R1     STOP  ,    STOP  CR1
-	uint32_t timeout = 100000;	//    
-	while ((I2C1->CR1 & I2C_CR1_STOP) && timeout--){
-	__NOP(); //     
-		};
-	if (timeout == 0) {
-		//   
+void I2C1_ER_IRQHandler(void) {
+	uint16_t sr1 = I2C1->SR1;
+	uint8_t status = I2C_STATUS_ERROR;
+	
+	if (sr1 & I2C_SR1_AF) {
+		// AF (Acknowledge Failure) -   ,  
+		status = I2C_STATUS_NACK;
+		I2C1->CR1 |= I2C_CR1_STOP;
+	} else if (!(sr1 & I2C_SR1_ARLO)) {
+		// BERR/OVR -  .  ARLO      
+		I2C1->CR1 |= I2C_CR1_STOP;
+	}
+	//     0
+	I2C1->SR1 = (uint16_t)~(I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR);
+	
+	if (i2cActive) {
+		i2cComplete(status);
 	}
 }
 
 /**
 	******************************************************************************
-	* @brief		  
-	* @param		data	 
+	* @brief		    
+	* @param		None
 	* @retval		None
+	* @note			   I2C1    
 	******************************************************************************
 	*/
-void i2cWrite(uint8_t data) {
-	//    DR
-	I2C1->DR = data;
-	//   TXE (Transmit buffer Empty) - DR         . TXE    DR
-	uint32_t timeout = 100000;	//    
-	while (!(I2C1->SR1 & I2C_SR1_TXE) && timeout--) {
+static void i2cStartNext(void) {
+	if (i2cHead == i2cTail) {
+		i2cActive = 0;		//   -  
+		return;
+	}
+	i2cActive = 1;
+	i2cIndex = 0;
+	i2cStartTick = getSysTickCountDelay();	//    
+	
+	// STOP  R1     STOP  .
+	//  START       STOP
+	// (     SCL)
+	uint32_t timeout = 1000;	//    
+	while ((I2C1->CR1 & I2C_CR1_STOP) && timeout--) {
 		__NOP(); //     
-		};
-	if (timeout == 0) {
-		//   
 	}
+	
+	I2CTransaction *t = &i2cQueue[i2cTail];
+	i2cDmaMode = (t->rxData == 0 && t->len >= I2C_DMA_MIN_LEN);
+	if (i2cDmaMode) {
+		//  :   DMA,   TXE  .
+		//  DMA      (  ADDR)
+		i2cDmaDone = 0;
+		dmaChannelConfig(DMA_CHANNEL_I2C1_TX, (uint32_t)&I2C1->DR, (uint32_t)t->data, t->len);
+		I2C1->CR2 |= I2C_CR2_DMAEN | I2C_CR2_ITEVTEN;
+	} else {
+		//  :     
+		I2C1->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN;
+	}
+	//   START
+	I2C1->CR1 |= I2C_CR1_START;
+}
+
+/**
+	******************************************************************************
+	* @brief		  
+	* @param		status	 
+	* @retval		None
+	******************************************************************************
+	*/
+static void i2cComplete(uint8_t status) {
+	I2CTransaction *t = &i2cQueue[i2cTail];
+	I2CCallback callback = t->callback;
+	void *ctx = t->ctx;
+	
+	//      DMA    
+	I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN);
+	//         ,
+	// POS -     
+	I2C1->CR1 &= ~I2C_CR1_POS;
+	I2C1->CR1 |= I2C_CR1_ACK;
+	if (i2cDmaMode) {
+		dmaChannelDisable(DMA_CHANNEL_I2C1_TX);
+		i2cDmaMode = 0;
+	}
+	//    
+	i2cTail = (i2cTail + 1) & (I2C_QUEUE_SIZE - 1);
+	
+	if (callback) {
+		callback(status, ctx);
+	}
+	i2cStartNext();
+}
+
+/**
+	******************************************************************************
+	* @brief		     DR
+	* @param		t	 
+	* @retval		None
+	******************************************************************************
+	*/
+static void i2cWriteNext(const I2CTransaction *t) {
+	I2C1->DR = t->data[i2cIndex++];
+	if (i2cIndex >= t->len) {
+		//    -  BTF,   TXE   
+		I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		     DR
+	* @param		t	 
+	* @retval		None
+	* @note			         ( 
+	*						  BTF  I2C1_EV_IRQHandler).
+	*						    ( )  ACK
+	*						  STOP,    
+	*						    (~22   400 ) - 
+	*						I2C_IRQ_PRIORITY    
+	******************************************************************************
+	*/
+static void i2cReadNext(const I2CTransaction *t) {
+	t->rxData[i2cIndex++] = (uint8_t)I2C1->DR;
+	if (i2cIndex + 1 == t->len) {
+		// EV7_1:   - ,    NACK
+		I2C1->CR1 &= ~I2C_CR1_ACK;
+		I2C1->CR1 |= I2C_CR1_STOP;
+	} else if (i2cIndex >= t->len) {
+		i2cComplete(I2C_STATUS_OK);
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		     
+	* @param		None
+	* @retval		1 -      I2C_TIMEOUT_MS  
+	* @note			      ,
+	*						    ,   
+	******************************************************************************
+	*/
+static uint8_t i2cAbortExpired(void) {
+	uint8_t expired = 0;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();	//  
+	
+	if (i2cActive && delaySysTick_nb_ms(i2cStartTick, I2C_TIMEOUT_MS + 1)) {
+		I2C1->CR1 |= I2C_CR1_STOP;
+		i2cComplete(I2C_STATUS_ERROR);
+		expired = 1;
+	}
+	
+	__set_PRIMASK(primask);
+	return expired;
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		status	 
+	* @param		ctx		   status  
+	* @retval		None
+	******************************************************************************
+	*/
+static void i2cSyncCallback(uint8_t status, void *ctx) {
+	*(volatile uint8_t*)ctx = status;
+}
+
+/**
+	******************************************************************************
+	* @brief		    DMA I2C1_TX
+	* @param		event	  (DMA_EVENT_*)
+	* @param		ctx		 
+	* @retval		None
+	******************************************************************************
+	*/
+static void i2cDmaCallback(uint8_t event, void *ctx) {
+	if (!i2cActive || !i2cDmaMode) {
+		return;
+	}
+	if (event & DMA_EVENT_ERROR) {
+		//   DMA -     
+		I2C1->CR1 |= I2C_CR1_STOP;
+		i2cComplete(I2C_STATUS_ERROR);
+	} else if (event & DMA_EVENT_COMPLETE) {
+		//     DR, STOP    BTF
+		i2cDmaDone = 1;
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		  APB1 (PCLK1)
+	* @param		None
+	* @retval		 PCLK1, 
+	* @note			  I2C_PCLK1_HZ  ,   
+	*						I2C_CCR_VALUE/I2C_TRISE_VALUE    .
+	*						    SystemCoreClock   PPRE1
+	******************************************************************************
+	*/
+static uint32_t i2cGetPCLK1(void) {
+#ifdef I2C_PCLK1_HZ
+	return I2C_PCLK1_HZ;
+#else
+	//  APB1: PPRE1 = 0xx - 1, 100 - 2, 101 - 4, 110 - 8, 111 - 16
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> 8;
+	uint32_t shift = (ppre1 & 0x04) ? ((ppre1 & 0x03) + 1) : 0;
+	return SystemCoreClock >> shift;
+#endif
 }
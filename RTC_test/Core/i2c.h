@@ -10,6 +10,7 @@
 #define I2C_H
 
 #include "stm32f10x.h"
+#include "pt.h"
 
 // ,   (     I2C: 0  )
 #define I2C_REQUEST_WRITE			0x00
@@ -19,11 +20,123 @@
 #define I2C_OWNADDRESS1_7BIT	0x00004000U
 #define I2C_MODE_I2C					0x00000000U
 
+/*    */
+#define I2C_MODE_STANDARD			0			//   ( 100 )
+#define I2C_MODE_FAST					1			//   ( 400 ), DUTY: Tlow/Thigh = 2
+#define I2C_MODE_FAST_16_9		2			//  , DUTY: Tlow/Thigh = 16/9
+
+/*    */
+#define I2C_SPEED_MODE				I2C_MODE_FAST
+#define I2C_SPEED_HZ					400000UL
+
+/*   APB1 (PCLK1), .     
+	 (sysClockTo72: PCLK1 = HCLK/2 = 36 ),    CR2, CCR  TRISE
+	    .   -  
+	     SystemCoreClock   APB1 */
+#define I2C_PCLK1_HZ					36000000UL
+
+/*   FREQ  CR2 -  PCLK1   */
+#define I2C_FREQ_VALUE(pclk)	((uint16_t)((pclk) / 1000000UL))
+
+/*   CCR.   ,    I2C_SPEED_HZ */
+#define I2C_DIV_CEIL(a, b)		(((a) + (b) - 1) / (b))
+#if I2C_SPEED_MODE == I2C_MODE_STANDARD
+	#define I2C_CCR_VALUE(pclk)	((uint16_t)I2C_DIV_CEIL((pclk), 2UL * I2C_SPEED_HZ))
+#elif I2C_SPEED_MODE == I2C_MODE_FAST
+	#define I2C_CCR_VALUE(pclk)	((uint16_t)(I2C_CCR_FS | I2C_DIV_CEIL((pclk), 3UL * I2C_SPEED_HZ)))
+#elif I2C_SPEED_MODE == I2C_MODE_FAST_16_9
+	#define I2C_CCR_VALUE(pclk)	((uint16_t)(I2C_CCR_FS | I2C_CCR_DUTY | I2C_DIV_CEIL((pclk), 25UL * I2C_SPEED_HZ)))
+#else
+	#error "I2C_SPEED_MODE:  "
+#endif
+
+/*   TRISE:    1000  ( )
+	  300  ( ),    PCLK1,  1 */
+#if I2C_SPEED_MODE == I2C_MODE_STANDARD
+	#define I2C_TRISE_VALUE(pclk)	((uint16_t)(I2C_FREQ_VALUE(pclk) + 1))
+#else
+	#define I2C_TRISE_VALUE(pclk)	((uint16_t)(I2C_FREQ_VALUE(pclk) * 300UL / 1000UL + 1))
+#endif
+
+/*    */
+#if (I2C_SPEED_MODE == I2C_MODE_STANDARD && I2C_SPEED_HZ > 100000UL) || (I2C_SPEED_HZ > 400000UL)
+	#error "I2C_SPEED_HZ     "
+#endif
+#ifdef I2C_PCLK1_HZ
+	#if (I2C_PCLK1_HZ < 2000000UL) || (I2C_PCLK1_HZ > 36000000UL)
+		#error "I2C_PCLK1_HZ:   PCLK1  I2C - 2..36 "
+	#endif
+	#if (I2C_SPEED_MODE != I2C_MODE_STANDARD) && (I2C_PCLK1_HZ < 4000000UL)
+		#error "I2C_PCLK1_HZ:     PCLK1     4 "
+	#endif
+#endif
+
+/*    ( ) */
+#define I2C_QUEUE_SIZE				8
+
+/*   I2C1  DMA1 Channel 6 ( I2C1).  DMA
+	    ,     I2C1_EV_IRQHandler
+	    .    ,   
+	 TIM2 (ASYNC_DELAY_IRQ_PRIORITY), TIM3  DMA  (KEYBOARD_IRQ_PRIORITY)
+	  RTC:  (EV7_1)       .
+	   (i2cWriteByte  .)      
+	    :      */
+#define I2C_IRQ_PRIORITY			0x01
+
+/*   ,   DMA1 Channel 6.
+	   (  LCD)     */
+#define I2C_DMA_MIN_LEN				8
+
+/*      ( START,    ),  */
+#define I2C_TIMEOUT_MS				10
+
+/*     i2cInit,  (     ) */
+#define I2C_STARTUP_MS				10
+
+/*    */
+#define I2C_STATUS_OK					0			//  
+#define I2C_STATUS_NACK				1			//    (AF)
+#define I2C_STATUS_ERROR			2			//   (BERR, ARLO)  
+
+/*       (  ) */
+typedef void (*I2CCallback)(uint8_t status, void *ctx);
+
+/*   */
+typedef struct {
+	uint8_t addr;									// 7-  
+	const uint8_t *data;					//   (    )
+	uint8_t *rxData;							//  , 0 -  
+	uint16_t len;									//  
+	I2CCallback callback;					//    (  0)
+	void *ctx;										//    
+} I2CTransaction;
+
+/*    i2cTransferThread.    
+	 :        */
+typedef struct {
+	Pt pt;												//  
+	uint8_t addr;									// 7-  
+	const uint8_t *data;					//  
+	uint8_t *rxData;							//  , 0 - 
+	uint16_t len;									//  
+	uint8_t byte;									//   
+	volatile uint8_t status;			//   (I2C_STATUS_*)
+} I2COp;
+
 /*   */
 void i2cInit(void);											//   I2C
-void i2cStart(void);										//   START
-void i2cStop(void);											//   STOP
-void i2cWrite(uint8_t); 								//   
-void i2cWriteByte(uint8_t, uint8_t);		//     
+uint8_t i2cSubmit(uint8_t, const uint8_t*, uint16_t, I2CCallback, void*);	//    
+uint8_t i2cSubmitRead(uint8_t, uint8_t*, uint16_t, I2CCallback, void*);		//     
+uint8_t i2cIsBusy(void);								//    
+uint8_t i2cIsReady(void);								//      
+void i2cWriteOpInit(I2COp*, uint8_t, const uint8_t*, uint16_t);	//    
+void i2cWriteByteOpInit(I2COp*, uint8_t, uint8_t);	//    
+void i2cReadOpInit(I2COp*, uint8_t, uint8_t*, uint16_t);	//    
+PT_THREAD(i2cTransferThread(I2COp*));	//   (    )
+void i2cWriteByte(uint8_t, uint8_t);		//      ()
+void i2cWriteBuffer(uint8_t, const uint8_t*, uint16_t);	//       ()
+uint8_t i2cReadBuffer(uint8_t, uint8_t*, uint16_t);			//       ()
+void I2C1_EV_IRQHandler(void);					//   I2C1
+void I2C1_ER_IRQHandler(void);					//   I2C1
 
 #endif	/* I2C_H */
@@ -1,25 +1,100 @@
 /**
 	******************************************************************************
 	* @file			lcd.c
-	* @brief		Функции для работы с LCD 1602 по шине I2C (PCF8574T)
+	* @brief		Функции для работы с LCD 1602/2004 по шине I2C (PCF8574T)
 	*
 	* LCD подключен через I2C расширитель портов PCF8574T.
   * Используется 4-битный режим передачи данных.
+  * Все функции получают дескриптор дисплея (LcdDisplay), на одной шине
+  * может быть до двух дисплеев с разными адресами PCF8574.
 	******************************************************************************
 	*/
 
 #include "lcd.h"
+#include <string.h>
 
 extern int keyPress;
 
+/* Начальное состояние дескриптора дисплея */
+#define LCD_DISPLAY_INIT(address, rows, cols, rowAddr)	{ \
+	(address), (rows), (cols), rowAddr, \
+	.hwAddr = 0xFF, \
+	.glyphSlot = {LCD_GLYPH_NONE, LCD_GLYPH_NONE, LCD_GLYPH_NONE, LCD_GLYPH_NONE, \
+	              LCD_GLYPH_NONE, LCD_GLYPH_NONE, LCD_GLYPH_NONE, LCD_GLYPH_NONE} \
+}
+
+/* Дисплеи на шине I2C1 (параметры - в lcd.h) */
+LcdDisplay lcdDisplays[LCD_COUNT] = {
+	LCD_DISPLAY_INIT(LCD0_ADDRESS, LCD0_ROWS, LCD0_COLS, LCD0_ROW_ADDR),
+#if LCD_COUNT > 1
+	LCD_DISPLAY_INIT(LCD1_ADDRESS, LCD1_ROWS, LCD1_COLS, LCD1_ROW_ADDR),
+#endif
+};
+
+/* Параметры дисплея. При одном дисплее - константы времени компиляции:
+	 указатель на дескриптор заменяется адресом lcdDisplays[0], и код
+	 не отличается от драйвера с глобальными переменными */
+#if LCD_COUNT == 1
+static const uint8_t lcdRowAddr[LCD_MAX_ROWS] = LCD0_ROW_ADDR;
+#define LCD_SELF(lcd)							((void)(lcd), &lcdDisplays[0])
+#define LCD_ADDR_OF(lcd)					LCD0_ADDRESS
+#define LCD_ROWS_OF(lcd)					LCD0_ROWS
+#define LCD_COLS_OF(lcd)					LCD0_COLS
+#define LCD_ROW_ADDR_OF(lcd, row)	lcdRowAddr[row]
+#else
+#define LCD_SELF(lcd)							(lcd)
+#define LCD_ADDR_OF(lcd)					((lcd)->address)
+#define LCD_ROWS_OF(lcd)					((lcd)->rows)
+#define LCD_COLS_OF(lcd)					((lcd)->cols)
+#define LCD_ROW_ADDR_OF(lcd, row)	((lcd)->rowAddr[row])
+#endif
+
+/* Промежуточный буфер поля, не помещающегося в строку */
+static char lcdFieldBuf[LCD_MAX_COLS];
+
+/* Изображения пользовательских символов 5x8 (по логическим номерам) */
+static const uint8_t lcdGlyphBitmaps[LCD_GLYPH_COUNT][LCD_GLYPH_ROWS] = {
+	{0x00, 0x0E, 0x1F, 0x1F, 0x1F, 0x0E, 0x00, 0x00},	// LCD_GLYPH_DEVICE_ON
+	{0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00, 0x00},	// LCD_GLYPH_DEVICE_OFF
+	{0x00, 0x0E, 0x15, 0x17, 0x11, 0x0E, 0x00, 0x00},	// LCD_GLYPH_ARMED
+	{0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00},	// LCD_GLYPH_BELL
+	{0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00},	// LCD_GLYPH_BAR1
+	{0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00},	// LCD_GLYPH_BAR2
+	{0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x00},	// LCD_GLYPH_BAR3
+	{0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x00},	// LCD_GLYPH_BAR4
+	{0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00},	// LCD_GLYPH_BAR5
+};
+
+/* Буфер пакетной передачи: каждая запись байта занимает 4 байта PCF8574 */
+static uint8_t lcdBurstBuf[LCD_BURST_CHARS * 4];
+static uint8_t lcdBurstLen = 0;		// Пакет передается целиком внутри одного вызова lcdFlush,
+																	// поэтому буфер общий для всех дисплеев
+
+/* Байт PCF8574 в режиме чтения регистра команд: D4-D7 = 1 (квазидвунаправленные
+	 выводы PCF8574 становятся входами), R/W = 1, RS = 0 */
+#define LCD_READ_CONTROL	(LCD_D4_PIN | LCD_D5_PIN | LCD_D6_PIN | LCD_D7_PIN | LCD_RW_PIN | LCD_BL_PIN)
+
+/* Адрес DDRAM для проверки чтения при инициализации: оба полубайта
+	 отличаются от 0xF, который читается, если R/W не подключен */
+#define LCD_PROBE_ADDR		0x45
+
+/* Команды инициализации в 4-битном режиме */
+static const uint8_t lcdInitCommands[] = {
+	LCD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8_DOTS,	// 2 строки, 5x8 точек
+	LCD_DISPLAY_CONTROL | LCD_DISPLAY_OFF,												// Выключение дисплея
+	LCD_CLEAR_DISPLAY,																						// Очистка дисплея
+	LCD_ENTRY_MODE_SET | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_OFF,		// Режим ввода
+};
+
 /*******************************************************************************
-	* @brief  Отправка полубайта (4 бита) на LCD
+	* @brief  Формирование последовательности стробирования полубайта для PCF8574T
+	* @param  buf: буфер для двух байт (E = 1, затем E = 0)
 	* @param  data: данные (нижние 4 бита)
 	* @param  rs: флаг RS (0 - команда, 1 - данные)
-	* @retval None
+	* @retval Указатель на следующую свободную позицию буфера
 	******************************************************************************
 	*/
-static void lcdSendNibble(uint8_t data, uint8_t rs) {
+static uint8_t* lcdPackNibble(uint8_t *buf, uint8_t data, uint8_t rs) {
     
 	// Извлекаем из data только младшие 4 бита
 	// data & 0x0F = маска, оставляющая только биты 0-3
@@ -50,145 +125,637 @@ static void lcdSendNibble(uint8_t data, uint8_t rs) {
 	// 1. Установить бит E (Enable) в 1
 	// 2. Выдержать паузу (не менее 450 нс)
 	// 3. Установить бит E в 0
+	// Байты передаются подряд в одной транзакции I2C. Передача одного байта
+	// занимает 9 тактов SCL (~22.5 мкс на 400 кГц, ~90 мкс на 100 кГц), поэтому
+	// длительность импульса E обеспечивается самой шиной, а между спадами E
+	// соседних записей проходит не менее двух байт (~45 мкс > 37 мкс выполнения).
     
-	// 1. Сначала выставляем на шину байт с установленным битом E
-	// (добавляем бит E к остальным установленным битам)
-	i2cWriteByte(LCD_ADDRESS, control | LCD_E_PIN);
-	
-	// 2. Пауза > 450 нс
-	delayDWT_us(500);
+	// 1. Байт с установленным битом E
+	*buf++ = control | LCD_E_PIN;
 	
-	// 3. Отправляем байт без бита E (устанавливаем E в 0)
+	// 2. Байт без бита E (устанавливаем E в 0)
 	// Это создает спад импульса, по которому LCD защелкивает данные
-	i2cWriteByte(LCD_ADDRESS, control);
+	*buf++ = control;
 	
-	// Пауза для стабилизации
-	delayDWT_us(500);
+	return buf;
 }
 
 /*******************************************************************************
-  * @brief  Запись байта в 4-битном режиме
+  * @brief  Формирование последовательности передачи байта в 4-битном режиме
+  * @param  buf: буфер для четырех байт
   * @param  data: данные для записи
   * @param  rs: флаг RS
+  * @retval Указатель на следующую свободную позицию буфера
+	******************************************************************************
+	*/
+static uint8_t* lcdPackByte(uint8_t *buf, uint8_t data, uint8_t rs) {
+    // Старший ниббл
+    buf = lcdPackNibble(buf, data >> 4, rs);
+    // Младший ниббл
+    return lcdPackNibble(buf, data & 0x0F, rs);
+}
+
+/*******************************************************************************
+	* @brief  Подготовка записи полубайта (4 бита) протопотоком i2cTransferThread
+	* @param  lcd: дисплей
+	* @param  data: данные (нижние 4 бита)
+	* @param  rs: флаг RS (0 - команда, 1 - данные)
+	* @retval None
+	******************************************************************************
+	*/
+static void lcdPrepareNibble(LcdDisplay *lcd, uint8_t data, uint8_t rs) {
+	lcd = LCD_SELF(lcd);
+	lcdPackNibble(lcd->ptBuf, data, rs);
+	i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->ptBuf, 2);
+}
+
+/*******************************************************************************
+  * @brief  Запись байта в 4-битном режиме (оба ниббла за одну транзакцию I2C)
+  * @param  lcd: дисплей
+  * @param  data: данные для записи
+  * @param  rs: флаг RS
+  * @retval None
+	******************************************************************************
+	*/
+static void lcdWrite4Bits(LcdDisplay *lcd, uint8_t data, uint8_t rs) {
+    lcd = LCD_SELF(lcd);
+    uint8_t buf[4];
+    lcdPackByte(buf, data, rs);
+    i2cWriteBuffer(LCD_ADDR_OF(lcd), buf, sizeof(buf));
+}
+
+/*******************************************************************************
+  * @brief  Отправка накопленного пакета одной транзакцией I2C
+  * @param  lcd: дисплей
   * @retval None
 	******************************************************************************
 	*/
-static void lcdWrite4Bits(uint8_t data, uint8_t rs) {
-    // Отправка старшего ниббла
-    lcdSendNibble(data >> 4, rs);
-    // Отправка младшего ниббла
-    lcdSendNibble(data & 0x0F, rs);
+static void lcdBurstSend(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    if (lcdBurstLen) {
+        i2cWriteBuffer(LCD_ADDR_OF(lcd), lcdBurstBuf, lcdBurstLen);
+        lcdBurstLen = 0;
+    }
 }
 
 /*******************************************************************************
-  * @brief  Отправка команды на LCD
+  * @brief  Добавление байта в пакет (при заполнении пакет отправляется)
+  * @param  lcd: дисплей
+  * @param  data: данные или команда
+  * @param  rs: флаг RS (0 - команда, 1 - данные)
+  * @retval None
+  * @note   Допустимы только команды с временем выполнения ~37 мкс
+  *         (не LCD_CLEAR_DISPLAY и не LCD_RETURN_HOME)
+	******************************************************************************
+	*/
+static void lcdBurstPut(LcdDisplay *lcd, uint8_t data, uint8_t rs) {
+    lcd = LCD_SELF(lcd);
+    if (lcdBurstLen + 4u > sizeof(lcdBurstBuf)) {
+        lcdBurstSend(lcd);
+    }
+    lcdPackByte(&lcdBurstBuf[lcdBurstLen], data, rs);
+    lcdBurstLen += 4;
+}
+
+/*******************************************************************************
+  * @brief  Протопоток ожидания готовности контроллера
+  * @param  lcd: дисплей
+  * @param  pt: состояние протопотока
+  * @param  fallbackMs: задержка, если флаг занятости BF прочитать нельзя
+  * @retval PT_WAITING - контроллер занят, PT_ENDED - готов
+  *
+  * В 4-битном режиме чтение регистра команд - два строба E: по первому
+  * контроллер выдает старший полубайт (D7 - BF), который читается из PCF8574,
+  * второй строб (младший полубайт, счетчик адреса) нужен для синхронизации.
+  * R/W меняется только при E = 0 (время установки адреса tAS), после
+  * чтения возвращается в 0 до следующего фронта E.
+  * Опрос выполняется, только если проверка при инициализации подтвердила
+  * чтение (см. lcdInitThread). Если BF не сбросился за LCD_BUSY_TIMEOUT_MS,
+  * адрес DDRAM считается неизвестным и драйвер переходит на фиксированные
+  * задержки.
+	******************************************************************************
+	*/
+static PT_THREAD(lcdWaitReadyThread(LcdDisplay *lcd, Pt *pt, uint8_t fallbackMs)) {
+	lcd = LCD_SELF(lcd);
+	PT_BEGIN(pt);
+	
+#ifdef LCD_BUSY_FLAG
+	if (lcd->busyFlagOk) {
+		lcd->busyTick = getSysTickCountDelay();
+		do {
+			// R/W = 1 при E = 0, затем строб E: контроллер выдает старший полубайт
+			lcd->busyBuf[0] = LCD_READ_CONTROL;
+			lcd->busyBuf[1] = LCD_READ_CONTROL | LCD_E_PIN;
+			i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->busyBuf, 2);
+			PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+			i2cReadOpInit(&lcd->op, LCD_ADDR_OF(lcd), &lcd->busyRx[0], 1);
+			PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+			if (lcd->op.status != I2C_STATUS_OK) {
+				lcd->busyFlagOk = 0;
+			}
+			
+			// Спад E, строб младшего полубайта, возврат R/W = 0 при E = 0
+			lcd->busyBuf[0] = LCD_READ_CONTROL;
+			lcd->busyBuf[1] = LCD_READ_CONTROL | LCD_E_PIN;
+			lcd->busyBuf[2] = LCD_READ_CONTROL;
+			lcd->busyBuf[3] = LCD_BL_PIN;
+			i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->busyBuf, 4);
+			PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+			
+			if (delaySysTick_nb_ms(lcd->busyTick, LCD_BUSY_TIMEOUT_MS + 1)) {
+				lcd->busyFlagOk = 0;
+				lcd->hwAddr = 0xFF;
+			}
+		} while (lcd->busyFlagOk && (lcd->busyRx[0] & LCD_BF_PIN));
+	}
+	if (!lcd->busyFlagOk) {
+		PT_DELAY_MS(pt, lcd->cmdTick, fallbackMs);
+	}
+#else
+	PT_DELAY_MS(pt, lcd->cmdTick, fallbackMs);
+#endif
+	
+	PT_END(pt);
+}
+
+/*******************************************************************************
+  * @brief  Протопоток отправки команды на LCD
+  * @param  lcd: дисплей
+  * @param  pt: состояние протопотока
+  * @param  cmd: команда (используется при первом вызове)
+  * @retval PT_WAITING - команда выполняется, PT_ENDED - выполнена
+	******************************************************************************
+	*/
+PT_THREAD(lcdSendCommandThread(LcdDisplay *lcd, Pt *pt, uint8_t cmd)) {
+	lcd = LCD_SELF(lcd);
+	PT_BEGIN(pt);
+	
+	lcdPackByte(lcd->ptBuf, cmd, 0);
+	i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->ptBuf, 4);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	
+	// Ожидание по BF, иначе одна задержка для всех команд:
+	// самые долгие (очистка и возврат) занимают 1.52 мс
+	PT_SPAWN(pt, &lcd->waitPt, lcdWaitReadyThread(lcd, &lcd->waitPt, LCD_COMMAND_MS));
+	
+	PT_END(pt);
+}
+
+/*******************************************************************************
+  * @brief  Отправка команды на LCD (блокирующая)
+  * @param  lcd: дисплей
   * @param  cmd: команда
   * @retval None
 	******************************************************************************
 	*/
-void lcdSendCommand(uint8_t cmd) {
-    lcdWrite4Bits(cmd, 0);
-    if (cmd == LCD_CLEAR_DISPLAY || cmd == LCD_RETURN_HOME) {
-        delayDWT_ms(3);
-    } else {
-        delayDWT_ms(3);
-		}
+void lcdSendCommand(LcdDisplay *lcd, uint8_t cmd) {
+	lcd = LCD_SELF(lcd);
+	Pt pt;
+	PT_INIT(&pt);
+	while (PT_SCHEDULE(lcdSendCommandThread(lcd, &pt, cmd))) {
+		__NOP();
+	}
 }
 
 /*******************************************************************************
   * @brief  Отправка данных на LCD
+  * @param  lcd: дисплей
   * @param  data: данные
   * @retval None
 	******************************************************************************
 	*/
-void lcdSendData(uint8_t data) {
-    lcdWrite4Bits(data, 1);
-    delayDWT_ms(1);
+void lcdSendData(LcdDisplay *lcd, uint8_t data) {
+    lcd = LCD_SELF(lcd);
+    lcdWrite4Bits(lcd, data, 1);
+    PT_INIT(&lcd->waitPt);
+    while (PT_SCHEDULE(lcdWaitReadyThread(lcd, &lcd->waitPt, LCD_DATA_MS))) {
+        __NOP();
+    }
 }
 
 /*******************************************************************************
   * @brief  Очистка дисплея
-  * @param  None
+  * @param  lcd: дисплей
   * @retval None
 	******************************************************************************
 	*/
-void lcdClear(void) {
-    lcdSendCommand(LCD_CLEAR_DISPLAY);
+void lcdClear(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    // Очищается только кадровый буфер, на дисплей изменения попадут при lcdFlush
+    memset(lcd->frame, ' ', sizeof(lcd->frame));
+    lcd->row = 0;
+    lcd->col = 0;
 }
 
 /*******************************************************************************
   * @brief  Включение курсора
-  * @param  None
+  * @param  lcd: дисплей
   * @retval None
 	******************************************************************************
 	*/
-void lcdCursorOn(void) {
-    lcdSendCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_ON);
+void lcdCursorOn(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    lcd->cursorVisible = 1;
+    // До завершения инициализации режим курсора задает lcdInitThread
+    if (lcd->ready) {
+        lcdSendCommand(lcd, LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_ON);
+    }
 }
 
 /*******************************************************************************
   * @brief  Выключение курсора
-  * @param  None
+  * @param  lcd: дисплей
   * @retval None
 	******************************************************************************
 	*/
-void lcdCursorOff(void) {
-    lcdSendCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);
+void lcdCursorOff(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    lcd->cursorVisible = 0;
+    if (lcd->ready) {
+        lcdSendCommand(lcd, LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);
+    }
 }
 
 /*******************************************************************************
-  * @brief  Установка позиции курсора
-  * @param  row: строка (0 или 1)
-  * @param  col: столбец (0-15)
+  * @brief  Установка позиции курсора (позиции вывода в кадровом буфере)
+  * @param  lcd: дисплей
+  * @param  row: строка (0 - количество строк - 1)
+  * @param  col: столбец (0 - ширина строки - 1)
   * @retval None
+  * @note   Видимый курсор переносится в эту позицию при lcdFlush
 	******************************************************************************
 	*/
-void lcdSetCursor(uint8_t row, uint8_t col) {
-    uint8_t address;
-    
-    // Адреса начала строк в DDRAM
-    if (row == 0) {
-        address = 0x00;
-    } else {
-        address = 0x40;
-    }
-    address += col;
-    
-    // Отправка команды установки адреса
-    lcdSendCommand(LCD_SET_DDRAM_ADDR | address);
+void lcdSetCursor(LcdDisplay *lcd, uint8_t row, uint8_t col) {
+    lcd = LCD_SELF(lcd);
+    lcd->row = (row < LCD_ROWS_OF(lcd)) ? row : LCD_ROWS_OF(lcd) - 1;
+    lcd->col = (col < LCD_COLS_OF(lcd)) ? col : LCD_COLS_OF(lcd);
 }
 
 /*******************************************************************************
   * @brief  Вывод символа
+  * @param  lcd: дисплей
   * @param  c: символ
   * @retval None
 	******************************************************************************
 	*/
-void lcdPrintChar(char c) {
-    lcdSendData(c);
+void lcdPrintChar(LcdDisplay *lcd, char c) {
+    lcd = LCD_SELF(lcd);
+    // Символы за пределами видимой строки отбрасываются
+    if (lcd->col < LCD_COLS_OF(lcd)) {
+        lcd->frame[lcd->row][lcd->col++] = c;
+    }
 }
 
 /*******************************************************************************
   * @brief  Вывод строки
+  * @param  lcd: дисплей
   * @param  str: указатель на строку
   * @retval None
 	******************************************************************************
 	*/
-void lcdPrintString(const char* str) {
+void lcdPrintString(LcdDisplay *lcd, const char* str) {
+    lcd = LCD_SELF(lcd);
     while (*str) {
-        lcdPrintChar(*str++);
+        lcdPrintChar(lcd, *str++);
+    }
+}
+
+/*******************************************************************************
+  * @brief  Начало поля фиксированной ширины
+  * @param  lcd: дисплей
+  * @param  len: ширина поля (не более ширины строки)
+  * @retval Место в кадровом буфере, если поле помещается в строку,
+  *         иначе промежуточный буфер (вывод с обрезкой в lcdFieldEnd)
+	******************************************************************************
+	*/
+static char* lcdFieldBegin(LcdDisplay *lcd, uint8_t len) {
+    lcd = LCD_SELF(lcd);
+    if (lcd->col + len <= LCD_COLS_OF(lcd)) {
+        return &lcd->frame[lcd->row][lcd->col];
+    }
+    return lcdFieldBuf;
+}
+
+/*******************************************************************************
+  * @brief  Завершение поля фиксированной ширины
+  * @param  lcd: дисплей
+  * @param  field: указатель, полученный от lcdFieldBegin
+  * @param  len: ширина поля
+  * @retval None
+	******************************************************************************
+	*/
+static void lcdFieldEnd(LcdDisplay *lcd, const char *field, uint8_t len) {
+    lcd = LCD_SELF(lcd);
+    if (field != lcdFieldBuf) {
+        lcd->col += len;
+        return;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        lcdPrintChar(lcd, field[i]);
+    }
+}
+
+/*******************************************************************************
+  * @brief  Вывод числа фиксированной ширины с ведущими нулями
+  * @param  lcd: дисплей
+  * @param  value: число
+  * @param  width: количество цифр (старшие разряды отбрасываются)
+  * @retval None
+	******************************************************************************
+	*/
+void lcdPrintUint(LcdDisplay *lcd, uint32_t value, uint8_t width) {
+    lcd = LCD_SELF(lcd);
+    if (width > LCD_COLS_OF(lcd)) {
+        width = LCD_COLS_OF(lcd);
+    }
+    char *field = lcdFieldBegin(lcd, width);
+    fmtUint(field, value, width);
+    lcdFieldEnd(lcd, field, width);
+}
+
+/*******************************************************************************
+  * @brief  Вывод флага включения ("ON " или "OFF")
+  * @param  lcd: дисплей
+  * @param  on: 0 - выключено, иначе включено
+  * @retval None
+	******************************************************************************
+	*/
+void lcdPrintOnOff(LcdDisplay *lcd, uint8_t on) {
+    lcd = LCD_SELF(lcd);
+    char *field = lcdFieldBegin(lcd, FMT_ONOFF_LEN);
+    fmtOnOff(field, on);
+    lcdFieldEnd(lcd, field, FMT_ONOFF_LEN);
+}
+
+/*******************************************************************************
+  * @brief  Вывод времени ЧЧ:ММ:СС
+  * @param  lcd: дисплей
+  * @param  td: время
+  * @retval None
+	******************************************************************************
+	*/
+void lcdPrintTime(LcdDisplay *lcd, const RTCTimeDate *td) {
+    lcd = LCD_SELF(lcd);
+    char *field = lcdFieldBegin(lcd, FMT_TIME_LEN);
+    fmtTime(field, td);
+    lcdFieldEnd(lcd, field, FMT_TIME_LEN);
+}
+
+/*******************************************************************************
+  * @brief  Вывод даты ДД/ММ/ГГГГ
+  * @param  lcd: дисплей
+  * @param  td: дата
+  * @retval None
+	******************************************************************************
+	*/
+void lcdPrintDate(LcdDisplay *lcd, const RTCTimeDate *td) {
+    lcd = LCD_SELF(lcd);
+    char *field = lcdFieldBegin(lcd, FMT_DATE_LEN);
+    fmtDate(field, td);
+    lcdFieldEnd(lcd, field, FMT_DATE_LEN);
+}
+
+/*******************************************************************************
+  * @brief  Проверка, отображается ли символ слота CGRAM в кадровом буфере
+  * @param  lcd: дисплей
+  * @param  slot: номер слота (код символа 0-7)
+  * @retval 1 - символ есть в кадре, 0 - нет
+	******************************************************************************
+	*/
+static uint8_t lcdGlyphInFrame(LcdDisplay *lcd, uint8_t slot) {
+    lcd = LCD_SELF(lcd);
+    for (uint8_t row = 0; row < LCD_ROWS_OF(lcd); row++) {
+        for (uint8_t col = 0; col < LCD_COLS_OF(lcd); col++) {
+            if ((uint8_t)lcd->frame[row][col] == slot) {
+                return 1;
+            }
+        }
     }
+    return 0;
 }
 
 /*******************************************************************************
-  * @brief  Инициализация LCD
-  * @param  None
+  * @brief  Замена отметок использования слотов порядковыми номерами
+  * @param  lcd: дисплей
   * @retval None
+  *
+  * Вызывается перед переполнением glyphClock: отметки становятся 1..8
+  * в прежнем порядке, поэтому отметка слота никогда не больше счетчика
+  * и давность сравнивается без учета переполнения.
+	******************************************************************************
+	*/
+static void lcdGlyphRenormalize(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    uint16_t rank[LCD_GLYPH_SLOTS];
+    
+    for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+        rank[slot] = 1;
+        for (uint8_t other = 0; other < LCD_GLYPH_SLOTS; other++) {
+            if (lcd->glyphUsed[other] < lcd->glyphUsed[slot] ||
+                (lcd->glyphUsed[other] == lcd->glyphUsed[slot] && other < slot)) {
+                rank[slot]++;
+            }
+        }
+    }
+    for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+        lcd->glyphUsed[slot] = rank[slot];
+    }
+    lcd->glyphClock = LCD_GLYPH_SLOTS;
+}
+
+/*******************************************************************************
+  * @brief  Код символа CGRAM для логического номера
+  * @param  lcd: дисплей
+  * @param  id: логический номер (LCD_GLYPH_xxx)
+  * @retval Код символа для кадрового буфера (0-7), ' ' - неверный номер
+  *
+  * Если символ уже загружен, обновляется только отметка использования.
+  * Иначе занимается свободный слот или слот, не использованный дольше всех
+  * среди отсутствующих в кадре (символы на экране не подменяются),
+  * изображение передается в CGRAM при ближайшем lcdFlush.
 	******************************************************************************
 	*/
-void lcdInit(void) {
+char lcdGlyphCode(LcdDisplay *lcd, uint8_t id) {
+    lcd = LCD_SELF(lcd);
+    if (id >= LCD_GLYPH_COUNT) {
+        return ' ';
+    }
+    if (lcd->glyphClock == 0xFFFF) {
+        lcdGlyphRenormalize(lcd);
+    }
+    lcd->glyphClock++;
+    
+    uint8_t victim = LCD_GLYPH_NONE;
+    uint8_t victimFree = 0;
+    uint16_t victimAge = 0;
+    for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+        if (lcd->glyphSlot[slot] == id) {
+            lcd->glyphUsed[slot] = lcd->glyphClock;
+            return (char)slot;
+        }
+        // Свободный слот (первый) предпочтительнее любого занятого
+        if (lcd->glyphSlot[slot] == LCD_GLYPH_NONE) {
+            if (!victimFree) {
+                victim = slot;
+                victimFree = 1;
+            }
+            continue;
+        }
+        uint16_t age = lcd->glyphClock - lcd->glyphUsed[slot];
+        if (!victimFree && age > victimAge && !lcdGlyphInFrame(lcd, slot)) {
+            victim = slot;
+            victimAge = age;
+        }
+    }
+    
+    // Все слоты на экране - вытесняется давний (его символы на экране изменятся)
+    if (victim == LCD_GLYPH_NONE) {
+        victim = 0;
+        for (uint8_t slot = 1; slot < LCD_GLYPH_SLOTS; slot++) {
+            if (lcd->glyphUsed[slot] < lcd->glyphUsed[victim]) {
+                victim = slot;
+            }
+        }
+    }
+    
+    lcd->glyphSlot[victim] = id;
+    lcd->glyphUsed[victim] = lcd->glyphClock;
+    lcd->glyphDirty |= (uint8_t)(1u << victim);
+    return (char)victim;
+}
+
+/*******************************************************************************
+  * @brief  Вывод пользовательского символа
+  * @param  lcd: дисплей
+  * @param  id: логический номер (LCD_GLYPH_xxx)
+  * @retval None
+	******************************************************************************
+	*/
+void lcdPrintGlyph(LcdDisplay *lcd, uint8_t id) {
+    lcd = LCD_SELF(lcd);
+    lcdPrintChar(lcd, lcdGlyphCode(lcd, id));
+}
+
+/*******************************************************************************
+  * @brief  Вывод горизонтальной шкалы
+  * @param  lcd: дисплей
+  * @param  value: значение в делениях (0 - width * LCD_BAR_STEPS)
+  * @param  width: ширина шкалы в знакоместах
+  * @retval None
+  * @note   Используются не более двух слотов CGRAM: полное и частичное знакоместо
+	******************************************************************************
+	*/
+void lcdPrintBar(LcdDisplay *lcd, uint16_t value, uint8_t width) {
+    lcd = LCD_SELF(lcd);
+    for (uint8_t i = 0; i < width; i++) {
+        if (value >= LCD_BAR_STEPS) {
+            lcdPrintGlyph(lcd, LCD_GLYPH_BAR5);
+            value -= LCD_BAR_STEPS;
+        } else if (value > 0) {
+            lcdPrintGlyph(lcd, LCD_GLYPH_BAR1 + value - 1);
+            value = 0;
+        } else {
+            lcdPrintChar(lcd, ' ');
+        }
+    }
+}
+
+/*******************************************************************************
+  * @brief  Загрузка изображений новых символов в CGRAM
+  * @param  lcd: дисплей
+  * @retval None
+  * @note   Выполняется в пакете lcdFlush до вывода кодов символов
+	******************************************************************************
+	*/
+static void lcdGlyphUpload(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+        if (!(lcd->glyphDirty & (1u << slot))) {
+            continue;
+        }
+        const uint8_t *bitmap = lcdGlyphBitmaps[lcd->glyphSlot[slot]];
+        lcdBurstPut(lcd, LCD_SET_CGRAM_ADDR | (slot << 3), 0);
+        for (uint8_t row = 0; row < LCD_GLYPH_ROWS; row++) {
+            lcdBurstPut(lcd, bitmap[row], 1);
+        }
+        // Счетчик адреса указывает в CGRAM
+        lcd->hwAddr = 0xFF;
+    }
+    lcd->glyphDirty = 0;
+}
+
+/*******************************************************************************
+  * @brief  Вывод изменений кадрового буфера на дисплей
+  * @param  lcd: дисплей
+  * @retval None
+  *
+  * Отправляются только ячейки, отличающиеся от теневой копии DDRAM.
+  * Команда установки адреса добавляется только в начале несмежного участка,
+  * внутри участка адрес увеличивается контроллером автоматически.
+  * Все команды и данные передаются пакетами по LCD_BURST_CHARS записей.
+  * До завершения инициализации изменения остаются в кадровом буфере.
+  * Новые пользовательские символы загружаются в CGRAM в том же пакете.
+	******************************************************************************
+	*/
+void lcdFlush(LcdDisplay *lcd) {
+    lcd = LCD_SELF(lcd);
+    if (!lcd->ready) {
+        return;
+    }
+    if (lcd->glyphDirty) {
+        lcdGlyphUpload(lcd);
+    }
+    for (uint8_t row = 0; row < LCD_ROWS_OF(lcd); row++) {
+        for (uint8_t col = 0; col < LCD_COLS_OF(lcd); col++) {
+            if (lcd->frame[row][col] == lcd->shadow[row][col]) {
+                continue;
+            }
+            uint8_t address = LCD_ROW_ADDR_OF(lcd, row) + col;
+            if (address != lcd->hwAddr) {
+                lcdBurstPut(lcd, LCD_SET_DDRAM_ADDR | address, 0);
+            }
+            lcdBurstPut(lcd, lcd->frame[row][col], 1);
+            lcd->shadow[row][col] = lcd->frame[row][col];
+            lcd->hwAddr = address + 1;
+        }
+    }
+    
+    // Перенос видимого курсора в позицию вывода
+    if (lcd->cursorVisible) {
+        uint8_t address = LCD_ROW_ADDR_OF(lcd, lcd->row) + lcd->col;
+        if (address != lcd->hwAddr) {
+            lcdBurstPut(lcd, LCD_SET_DDRAM_ADDR | address, 0);
+            lcd->hwAddr = address;
+        }
+    }
+    
+    lcdBurstSend(lcd);
+}
+
+/*******************************************************************************
+  * @brief  Протопоток инициализации LCD
+  * @param  lcd: дисплей
+  * @param  pt: состояние протопотока
+  * @retval PT_WAITING - инициализация выполняется, PT_ENDED - завершена
+  * @note   Первый вызов очищает кадровый буфер, дальше функции вывода
+  *         можно вызывать до завершения: содержимое будет выведено в конце
+	******************************************************************************
+	*/
+PT_THREAD(lcdInitThread(LcdDisplay *lcd, Pt *pt)) {
+	lcd = LCD_SELF(lcd);
+	PT_BEGIN(pt);
+	
+	lcd->ready = 0;
+#ifdef LCD_BUSY_FLAG
+	lcd->busyFlagOk = 0;		// До проверки чтения - фиксированные задержки
+#endif
+	memset(lcd->frame, ' ', sizeof(lcd->frame));
+	lcd->row = 0;
+	lcd->col = 0;
+	lcd->cursorVisible = 0;
+	
 	// Задержка для стабилизации питания LCD
-	delayDWT_ms(40);
+	PT_DELAY_MS(pt, lcd->initTick, LCD_POWER_ON_MS);
     
 	// Начальная последовательность инициализации.
 	// Перед включением 4-битного режима необходимо трижды
@@ -196,67 +763,148 @@ void lcdInit(void) {
 	// После трехкратной отправки команды дисплей выравнивает
 	// свой внутренний счетчик и начинает правильно интерпретировать поток.
 	// Т.к. LCD_FUNCTION_SET | LCD_8BIT_MODE это 0x30 (0011 0000), а 
-	// send_nibble отправляет только 4 младшие бита, то необходимо сдвинуть данные
+	// передается только полубайт (4 младших бита), то необходимо сдвинуть данные
 	// на 4 разряда вправо, т.е. нужно отправить 0000 0011 (0x03)
-	lcdSendNibble(0x03, 0);  // 1
-	delayDWT_ms(6);
-	lcdSendNibble(0x03, 0);  // 2
-	delayDWT_ms(6);
-	lcdSendNibble(0x03, 0);  // 3
-	delayDWT_ms(6);
+	for (lcd->initStep = 0; lcd->initStep < 3; lcd->initStep++) {
+		lcdPrepareNibble(lcd, 0x03, 0);
+		PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+		PT_DELAY_MS(pt, lcd->initTick, LCD_SYNC_MS);
+	}
 
 	// Переход в 4-битный режим
-	// Аналогично команда LCD_FUNCTION_SET | LCD_8BIT_MODE это 0x20 (0010 0000)
+	// Аналогично команда LCD_FUNCTION_SET | LCD_4BIT_MODE это 0x20 (0010 0000)
 	// соответственно, нужно сдвинуть на 4 разряда вправо, 0000 0010 (0x02)
-	lcdSendNibble(0x02, 0);  // Старший ниббл команды 0x20
-	delayDWT_ms(6);
+	lcdPrepareNibble(lcd, 0x02, 0);  // Старший ниббл команды 0x20
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	PT_DELAY_MS(pt, lcd->initTick, LCD_SYNC_MS);
 
 	// Теперь можно отправлять команды в 4-х битном режиме.
+	for (lcd->initStep = 0; lcd->initStep < sizeof(lcdInitCommands); lcd->initStep++) {
+		PT_SPAWN(pt, &lcd->cmdPt, lcdSendCommandThread(lcd, &lcd->cmdPt, lcdInitCommands[lcd->initStep]));
+	}
+	
+	// После очистки DDRAM заполнена пробелами, адрес - 0
+	memset(lcd->shadow, ' ', sizeof(lcd->shadow));
+	lcd->hwAddr = 0x00;
+	
+#ifdef LCD_BUSY_FLAG
+	// Проверка чтения регистра команд: после установки адреса LCD_PROBE_ADDR
+	// оба полубайта счетчика адреса должны совпасть (BF = 0). Если R/W
+	// не подключен к P1, контроллер принимает два строба как запись команды
+	// 0xFF (установка адреса DDRAM 0x7F), выводы PCF8574 читаются как 1,
+	// и драйвер остается на фиксированных задержках
+	PT_SPAWN(pt, &lcd->cmdPt, lcdSendCommandThread(lcd, &lcd->cmdPt, LCD_SET_DDRAM_ADDR | LCD_PROBE_ADDR));
+	lcd->busyBuf[0] = LCD_READ_CONTROL;
+	lcd->busyBuf[1] = LCD_READ_CONTROL | LCD_E_PIN;
+	i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->busyBuf, 2);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	i2cReadOpInit(&lcd->op, LCD_ADDR_OF(lcd), &lcd->busyRx[0], 1);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	lcd->initStep = (lcd->op.status == I2C_STATUS_OK);		// Результат первого чтения
+	lcd->busyBuf[0] = LCD_READ_CONTROL;
+	lcd->busyBuf[1] = LCD_READ_CONTROL | LCD_E_PIN;
+	i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->busyBuf, 2);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	i2cReadOpInit(&lcd->op, LCD_ADDR_OF(lcd), &lcd->busyRx[1], 1);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	lcd->initStep = lcd->initStep && (lcd->op.status == I2C_STATUS_OK);
+	// Спад E, возврат R/W = 0 при E = 0
+	lcd->busyBuf[0] = LCD_READ_CONTROL;
+	lcd->busyBuf[1] = LCD_BL_PIN;
+	i2cWriteOpInit(&lcd->op, LCD_ADDR_OF(lcd), lcd->busyBuf, 2);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	
+	lcd->busyFlagOk = lcd->initStep &&
+		(lcd->busyRx[0] & 0xF0) == (LCD_PROBE_ADDR & 0xF0) &&
+		(lcd->busyRx[1] & 0xF0) == ((LCD_PROBE_ADDR << 4) & 0xF0);
+	if (lcd->busyFlagOk) {
+		lcd->hwAddr = LCD_PROBE_ADDR;
+	} else {
+		// Адрес задается заново при выводе, выполнение принятой
+		// команды - фиксированная задержка
+		lcd->hwAddr = 0xFF;
+		PT_DELAY_MS(pt, lcd->cmdTick, LCD_DATA_MS);
+	}
+#endif
     
-	// Установка режима: 2 строки, 5x8 точек
-	lcdSendCommand(LCD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8_DOTS);
-    
-	// Выключение дисплея
-	lcdSendCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_OFF);
-    
-	// Очистка дисплея
-	lcdSendCommand(LCD_CLEAR_DISPLAY);
-    
-	// Установка режима ввода
-	lcdSendCommand(LCD_ENTRY_MODE_SET | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_OFF);
-    
-	// Включение дисплея с курсором
-	lcdSendCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);
+	// Включение дисплея (курсор - по вызовам lcdCursorOn/Off во время инициализации)
+	PT_SPAWN(pt, &lcd->cmdPt, lcdSendCommandThread(lcd, &lcd->cmdPt, LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | (lcd->cursorVisible ? LCD_BLINK_ON : LCD_BLINK_OFF)));
     
 	// Включение подсветки
-	i2cWriteByte(LCD_ADDRESS, LCD_BL_PIN);
+	i2cWriteByteOpInit(&lcd->op, LCD_ADDR_OF(lcd), LCD_BL_PIN);
+	PT_WAIT_THREAD(pt, i2cTransferThread(&lcd->op));
+	
+	lcd->ready = 1;
+	
+	// Содержимое CGRAM после включения не определено: назначенные слоты загружаются заново
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+		if (lcd->glyphSlot[slot] != LCD_GLYPH_NONE) {
+			lcd->glyphDirty |= (uint8_t)(1u << slot);
+		}
+	}
+	
+	// Вывод содержимого, подготовленного во время инициализации
+	lcdFlush(lcd);
+	
+	PT_END(pt);
+}
+
+/*******************************************************************************
+  * @brief  Инициализация LCD (блокирующая)
+  * @param  lcd: дисплей
+  * @retval None
+	******************************************************************************
+	*/
+void lcdInit(LcdDisplay *lcd) {
+	lcd = LCD_SELF(lcd);
+	Pt pt;
+	PT_INIT(&pt);
+	while (PT_SCHEDULE(lcdInitThread(lcd, &pt))) {
+		__NOP();
+	}
+}
+
+/*******************************************************************************
+  * @brief  Проверка завершения инициализации LCD
+  * @param  lcd: дисплей
+  * @retval 1 - дисплей готов, 0 - инициализация выполняется
+	******************************************************************************
+	*/
+uint8_t lcdIsReady(LcdDisplay *lcd) {
+	lcd = LCD_SELF(lcd);
+	return lcd->ready;
 }
 
 /*******************************************************************************
   * @brief  Обновление времени на дисплее
+  * @param  lcd: дисплей
   * @param  time: указатель на структуру времени
   * @retval None
 	******************************************************************************
 	*/
-void lcdUpdateTime(RTCTimeDate* time) {
-	char buffer[17];
-	// Первая строка: дата
-	lcdSetCursor(0, 0);
-	sprintf(buffer, "%02d/%02d/%04d% 02d %s", 
-            time->day, time->month, time->year, time->weekday, getSchedulerState() ? "ON " : "OFF");
-	lcdPrintString(buffer);
+void lcdUpdateTime(LcdDisplay *lcd, RTCTimeDate* time) {
+	lcd = LCD_SELF(lcd);
+	// Первая строка: дата, день недели, состояние планировщика
+	lcdSetCursor(lcd, 0, 0);
+	lcdPrintDate(lcd, time);
+	lcdPrintChar(lcd, ' ');
+	lcdPrintUint(lcd, time->weekday, 1);
+	lcdPrintChar(lcd, ' ');
+	lcdPrintOnOff(lcd, getSchedulerState());
 //	// Добавление информации о состоянии планировщика
 //	lcdSetCursor(0, 13);
 //	getSchedulerState() ? lcdPrintString("ON ") : lcdPrintString("OFF");
     
-	// Вторая строка: время
-	lcdSetCursor(1, 0);
-	sprintf(buffer, "%02d:%02d:%02d     %s", 
-            time->hours, time->minutes, time->seconds, getDeviceState() ? "ON " : "OFF");
-	lcdPrintString(buffer);
+	// Вторая строка: время, состояние устройства
+	lcdSetCursor(lcd, 1, 0);
+	lcdPrintTime(lcd, time);
+	lcdPrintString(lcd, "     ");
+	lcdPrintOnOff(lcd, getDeviceState());
 	
 //	// Добавление информации о состоянии устройства
 //	lcdSetCursor(1, 13);
 //	getDeviceState() ? lcdPrintString("ON ") : lcdPrintString("OFF");
 	
+	// Отправка изменившихся символов
+	lcdFlush(lcd);
 }
@@ -1,7 +1,7 @@
 /**
   ******************************************************************************
   * @file			lcd.h
-  * @brief		Заголовочный файл модуля работы с LCD 1602 по шине I2C (PCF8574)
+  * @brief		Заголовочный файл модуля работы с LCD 1602/2004 по шине I2C (PCF8574)
   ******************************************************************************
   */
 
@@ -12,13 +12,66 @@
 #include "scheduler.h"
 #include "i2c.h"
 #include "delay.h"
-#include <stdio.h>
+#include "pt.h"
+#include "fmt.h"
 
-static void lcdSendNibble(uint8_t data, uint8_t rs);
-static void lcdWrite4Bits(uint8_t data, uint8_t rs);
+/* Количество дисплеев на шине I2C1 (1 или 2). При одном дисплее его параметры -
+	 константы времени компиляции, дескриптор в функциях не используется */
+#ifndef LCD_COUNT
+#define LCD_COUNT	1
+#endif
 
-/* Адрес LCD (PCF8574) на шине I2C*/
-#define LCD_ADDRESS	0x27
+/* Адреса начала строк в DDRAM */
+#define LCD_ROW_ADDR_1602	{0x00, 0x40}
+#define LCD_ROW_ADDR_1604	{0x00, 0x40, 0x10, 0x50}
+#define LCD_ROW_ADDR_2004	{0x00, 0x40, 0x14, 0x54}
+
+/* Дисплей 0: адрес PCF8574 на шине I2C, размер, адреса строк */
+#define LCD0_ADDRESS		0x27
+#define LCD0_ROWS				2
+#define LCD0_COLS				16
+#define LCD0_ROW_ADDR		LCD_ROW_ADDR_1602
+
+/* Дисплей 1 (при LCD_COUNT = 2) */
+#define LCD1_ADDRESS		0x3F
+#define LCD1_ROWS				4
+#define LCD1_COLS				20
+#define LCD1_ROW_ADDR		LCD_ROW_ADDR_2004
+
+/* Размер кадрового буфера (наибольший из дисплеев) */
+#if LCD_COUNT == 1
+#define LCD_MAX_ROWS		LCD0_ROWS
+#define LCD_MAX_COLS		LCD0_COLS
+#elif LCD_COUNT == 2
+#define LCD_MAX_ROWS		((LCD0_ROWS > LCD1_ROWS) ? LCD0_ROWS : LCD1_ROWS)
+#define LCD_MAX_COLS		((LCD0_COLS > LCD1_COLS) ? LCD0_COLS : LCD1_COLS)
+#else
+#error "LCD_COUNT: поддерживается 1 или 2 дисплея"
+#endif
+
+/* Дескрипторы дисплеев */
+#define LCD_DISPLAY(n)	(&lcdDisplays[(n)])
+#define LCD_MAIN				LCD_DISPLAY(0)			// Основной дисплей (экран времени и меню)
+
+/* Максимальное количество символов, передаваемых за одну транзакцию I2C */
+#define LCD_BURST_CHARS	16
+
+/* Задержки инициализации и выполнения команд, мс */
+#define LCD_POWER_ON_MS		40		// Стабилизация питания
+#define LCD_SYNC_MS				6			// После каждого полубайта синхронизации
+#define LCD_COMMAND_MS		3			// После команды (с запасом для очистки/возврата, 1.52 мс)
+#define LCD_DATA_MS				1			// После записи символа
+
+/* Ожидание готовности контроллера по флагу занятости BF: D4-D7 и R/W
+	 читаются через PCF8574 (R/W должен быть подключен к P1). Опрос BF
+	 включается, если при инициализации прочитан известный адрес DDRAM.
+	 На модулях с R/W, соединенным с GND, проверка не проходит (стробы
+	 чтения принимаются как безвредная команда установки адреса), и драйвер
+	 работает на фиксированных задержках. Если чтение перестало работать
+	 или BF не сбросился за LCD_BUSY_TIMEOUT_MS - также переход на задержки.
+	 Если закомментировать - только задержки */
+#define LCD_BUSY_FLAG
+#define LCD_BUSY_TIMEOUT_MS	5
 
 /* Команды HD44780 */
 #define LCD_CLEAR_DISPLAY    0x01
@@ -68,17 +121,95 @@ static void lcdWrite4Bits(uint8_t data, uint8_t rs);
 #define LCD_D6_PIN 0x40  // P6: Data bit 6
 #define LCD_D7_PIN 0x80  // P7: Data bit 7
 
+/* Флаг занятости BF - бит D7 старшего полубайта при чтении регистра команд */
+#define LCD_BF_PIN LCD_D7_PIN
+
+/* Пользовательские символы (CGRAM). Контроллер хранит не более
+	 LCD_GLYPH_SLOTS изображений 5x8, символы загружаются по требованию
+	 и вытесняются по давности использования (LRU) */
+#define LCD_GLYPH_SLOTS		8
+#define LCD_GLYPH_ROWS		8				// Строк в изображении (5x8)
+#define LCD_GLYPH_NONE		0xFF		// Слот свободен
+
+/* Логические номера символов (индексы таблицы изображений в lcd.c) */
+#define LCD_GLYPH_DEVICE_ON		0		// Устройство включено (закрашенный круг)
+#define LCD_GLYPH_DEVICE_OFF	1		// Устройство выключено (пустой круг)
+#define LCD_GLYPH_ARMED				2		// Расписание активно (часы)
+#define LCD_GLYPH_BELL				3		// Колокольчик
+#define LCD_GLYPH_BAR1				4		// Столбики шкалы: заполнено 1-5 точек по ширине
+#define LCD_GLYPH_BAR2				5
+#define LCD_GLYPH_BAR3				6
+#define LCD_GLYPH_BAR4				7
+#define LCD_GLYPH_BAR5				8
+#define LCD_GLYPH_COUNT				9
+#define LCD_BAR_STEPS					5		// Делений шкалы на одно знакоместо
+
+/* Дескриптор дисплея. Память выделяется в lcd.c (lcdDisplays),
+   поля изменяются только функциями модуля */
+typedef struct {
+	// Параметры
+	uint8_t address;									// Адрес PCF8574 на шине I2C
+	uint8_t rows;											// Количество строк
+	uint8_t cols;											// Количество столбцов
+	uint8_t rowAddr[LCD_MAX_ROWS];		// Адреса начала строк в DDRAM
+	
+	// Кадровый буфер: требуемое содержимое экрана (заполняется функциями вывода)
+	char frame[LCD_MAX_ROWS][LCD_MAX_COLS];
+	// Теневая копия DDRAM: содержимое, фактически отправленное на дисплей
+	char shadow[LCD_MAX_ROWS][LCD_MAX_COLS];
+	uint8_t row;											// Строка позиции вывода в кадровом буфере
+	uint8_t col;											// Столбец позиции вывода в кадровом буфере
+	uint8_t hwAddr;										// Текущий адрес DDRAM контроллера (0xFF - неизвестен)
+	uint8_t cursorVisible;						// Флаг: курсор отображается (нужно позиционировать)
+	uint8_t ready;										// Флаг: инициализация завершена
+	
+	// Кэш CGRAM: логический номер символа в каждом слоте и время последнего
+	// использования. Изображение загружается в контроллер при следующем lcdFlush
+	uint8_t glyphSlot[LCD_GLYPH_SLOTS];
+	uint16_t glyphUsed[LCD_GLYPH_SLOTS];	// Отметка последнего использования
+	uint16_t glyphClock;							// Счетчик обращений к кэшу (не меньше отметок glyphUsed)
+	uint8_t glyphDirty;								// Слоты, ожидающие загрузки (битовая маска)
+	
+	// Состояние протопотоков (инициализация и команды выполняются по одной)
+	I2COp op;													// Обмен с PCF8574
+	uint8_t ptBuf[4];									// Данные записи (полубайт - 2 байта, байт - 4)
+	Pt cmdPt;													// Дочерний протопоток команды инициализации
+	Pt waitPt;												// Дочерний протопоток ожидания готовности
+	uint32_t initTick;								// Начало задержки инициализации (SysTick, мс)
+	uint32_t cmdTick;									// Начало задержки выполнения команды (SysTick, мс)
+	uint8_t initStep;									// Шаг инициализации
+#ifdef LCD_BUSY_FLAG
+	uint8_t busyFlagOk;								// Флаг: чтение BF работает (иначе - задержки)
+	uint8_t busyBuf[4];								// Стробы E в режиме чтения
+	uint8_t busyRx[2];								// Прочитанные полубайты: старший (D7 - BF) и младший
+	uint32_t busyTick;								// Начало ожидания BF (SysTick, мс)
+#endif
+} LcdDisplay;
+
+extern LcdDisplay lcdDisplays[LCD_COUNT];
+
 /* Прототипы функций */
-void lcdInit(void);												// Инициализация LCD
-//void lcdSendCommand(uint8_t);						// Отправка команды на LCD
-//void lcdSend_Data(uint8_t);							// Отправка данных на LCD
-void lcdSetCursor(uint8_t, uint8_t);			// Установка позиции курсора
-void lcdPrintChar(char c);								// Вывод символа
-void lcdPrintString(const char*);					// Вывод строки
-void lcdClear(void);											// Очистка дисплея
-void lcdCursorOn(void);										// Включение курсора
-void lcdCursorOff(void);									// Выключение курсора
+void lcdInit(LcdDisplay*);										// Инициализация LCD (блокирующая)
+PT_THREAD(lcdInitThread(LcdDisplay*, Pt*));						// Протопоток инициализации LCD
+uint8_t lcdIsReady(LcdDisplay*);								// Проверка завершения инициализации
+//void lcdSendCommand(LcdDisplay*, uint8_t);					// Отправка команды на LCD
+PT_THREAD(lcdSendCommandThread(LcdDisplay*, Pt*, uint8_t));		// Протопоток отправки команды
+//void lcdSend_Data(LcdDisplay*, uint8_t);						// Отправка данных на LCD
+void lcdSetCursor(LcdDisplay*, uint8_t, uint8_t);				// Установка позиции курсора
+void lcdPrintChar(LcdDisplay*, char c);							// Вывод символа
+void lcdPrintString(LcdDisplay*, const char*);					// Вывод строки
+void lcdPrintUint(LcdDisplay*, uint32_t, uint8_t);				// Вывод числа фиксированной ширины
+void lcdPrintOnOff(LcdDisplay*, uint8_t);						// Вывод флага "ON "/"OFF"
+void lcdPrintTime(LcdDisplay*, const RTCTimeDate*);				// Вывод времени ЧЧ:ММ:СС
+void lcdPrintDate(LcdDisplay*, const RTCTimeDate*);				// Вывод даты ДД/ММ/ГГГГ
+char lcdGlyphCode(LcdDisplay*, uint8_t);						// Код символа CGRAM для логического номера
+void lcdPrintGlyph(LcdDisplay*, uint8_t);						// Вывод пользовательского символа
+void lcdPrintBar(LcdDisplay*, uint16_t, uint8_t);				// Вывод горизонтальной шкалы
+void lcdFlush(LcdDisplay*);										// Вывод изменений кадрового буфера на дисплей
+void lcdClear(LcdDisplay*);										// Очистка дисплея
+void lcdCursorOn(LcdDisplay*);									// Включение курсора
+void lcdCursorOff(LcdDisplay*);									// Выключение курсора
 // Обновление времени на дисплее
-void lcdUpdateTime(RTCTimeDate*);
+void lcdUpdateTime(LcdDisplay*, RTCTimeDate*);
 
 #endif /* LCD_H */
@@ -14,21 +14,40 @@
 	* PA5 -  R1
 	* PA6 -  R2
 	* PA7 -  R3
+	*
+	*     TIM3 (KEYBOARD_SCAN_HZ):   
+	*   ,     ( 
+	*   ),    .  
+	*        ,
+	*    ,    .
+	*   KEYBOARD_SCAN_DMA      DMA,
+	*        4 .
+	*        EXTI.
 	******************************************************************************
 	*/
 
 #include "matrix_keyboard.h"
 #include "lcd.h"
 #include "rtc.h"
+#include "event.h"
+#include "dma.h"
 
 
 /*   */
 extern RTCTimeDate currentTime;					//    rtc.c
 extern ScheduleTypeDef deviceSchedule;	//    rtc.c
 
-#define BOUNCE	20							//  
-#define LONG_TRESHOLD 100000		//      (100000     main, 500   5ms)
-#define SHORT_TRESHOLD 100			//     	(100     main, 5   5ms)
+/*   ,  (        ) */
+#define KEY_DEBOUNCE_MS				20		//     -   ()
+#define KEY_LONG_MS						2500	//     ( + KEY_LONG_OFFSET)
+#define KEY_REPEAT_DELAY_MS		600		//    
+#define KEY_REPEAT_PERIOD_MS	150		//  
+#define KEYBOARD_IDLE_MS			100		//           EXTI
+
+#if (1000 % KEYBOARD_SCAN_HZ) != 0
+#error "KEYBOARD_SCAN_HZ:       "
+#endif
+#define KEYBOARD_ROWS_MASK (EXTI_IMR_MR4 | EXTI_IMR_MR5 | EXTI_IMR_MR6 | EXTI_IMR_MR7)	//  EXTI  PA4-PA7
 
 // 
 enum {
@@ -79,7 +98,8 @@ int keyb [4][4] =
   {13, 14, 15, 16}
 };
 
-/*   (+100 -  ) */
+/*   (+KEY_LONG_OFFSET -  ) */
+#define KEY_LONG_OFFSET		100
 #define KEY_NONE					-1
 #define KEY_UP						2
 #define KEY_DOWN					10
@@ -91,6 +111,54 @@ int keyb [4][4] =
 #define KEY_SET_SCHEDULE	108
 #define KEY_ESC						16
 
+/*      (  -  ) */
+#define KEY_REPEAT_MASK		((1UL << KEY_UP) | (1UL << KEY_DOWN) | (1UL << KEY_LEFT) | (1UL << KEY_RIGHT))
+
+/*    (    TIM3  EXTI) */
+static uint8_t scanCol = 0;							// ,     ( DMA)
+static uint8_t scanRows[4];							//     ( 0 - R0, 1 - )
+static uint32_t scanTick = 0;						//  , 
+static int scanRaw = KEY_NONE;					//   
+static int scanStable = KEY_NONE;				//   
+static uint32_t scanChangeTick = 0;			//    
+static uint32_t scanPressTick = 0;			//   ( )
+static uint32_t scanRepeatTick = 0;			//    ()
+static uint32_t scanActiveTick = 0;			//      
+static uint8_t scanLongHandled = 0;			// :   
+
+#ifdef KEYBOARD_SCAN_DMA
+/*  BSRR    col: 0    (PA3 - 0 ... PA0 - 3),
+	 1   ( BSx      -   ) */
+#define KEYBOARD_COL_PATTERN(col)	((0x0FUL & ~(1UL << (3 - (col)))) | (1UL << (3 - (col) + 16)))
+
+/*    DMA.       k 
+	   k+1,      1 ( 0
+	    ) */
+static const uint32_t scanColumnPattern[4] = {
+	KEYBOARD_COL_PATTERN(1), KEYBOARD_COL_PATTERN(2), KEYBOARD_COL_PATTERN(3), KEYBOARD_COL_PATTERN(0)
+};
+
+/*  :    4  (  GPIOA->IDR) */
+static volatile uint8_t scanSamples[8];
+
+static void keyboardDmaCallback(uint8_t event, void *ctx);
+#endif
+
+/*  :     (keyEventHead),
+	     (keyEventTail),    */
+static KeyEvent keyEventQueue[KEY_EVENT_QUEUE_SIZE];
+static volatile uint8_t keyEventHead = 0;
+static volatile uint8_t keyEventTail = 0;
+static volatile uint8_t keyEventSignaled = 0;	// EVENT_KEY     
+
+static void setColumn(uint8_t col);
+static void keyboardStartScan(void);
+static void keyboardEnableWakeup(void);
+static int keyboardDecode(void);
+static void keyboardScanUpdate(int btn);
+static void keyEventPush(uint8_t type, int key);
+static uint8_t keyEventSignal(void);
+
 
 /**
 	******************************************************************************
@@ -127,15 +195,174 @@ void keyboardInit(void){
 								GPIO_ODR_ODR5 |
 								GPIO_ODR_ODR6 | 
 								GPIO_ODR_ODR7;
+	
+	//  EXTI4-EXTI7 -   A,   
+	// (   keyboardEnableWakeup)
+	RCC->APB2ENR |= RCC_APB2ENR_AFIOEN;
+	AFIO->EXTICR[1] &= ~(AFIO_EXTICR2_EXTI4 | AFIO_EXTICR2_EXTI5 |
+											 AFIO_EXTICR2_EXTI6 | AFIO_EXTICR2_EXTI7);	// PA
+	EXTI->IMR &= ~KEYBOARD_ROWS_MASK;
+	EXTI->FTSR |= KEYBOARD_ROWS_MASK;
+	NVIC_SetPriority(EXTI4_IRQn, KEYBOARD_IRQ_PRIORITY);
+	NVIC_SetPriority(EXTI9_5_IRQn, KEYBOARD_IRQ_PRIORITY);
+	NVIC_EnableIRQ(EXTI4_IRQn);
+	NVIC_EnableIRQ(EXTI9_5_IRQn);
+	
+	// TIM3 -     KEYBOARD_SCAN_HZ.
+	//    APB1:   APB1  1 -  PCLK1
+	RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> 8;
+	uint32_t timClk = SystemCoreClock;
+	if (ppre1 & 0x4) {
+		timClk = (SystemCoreClock >> ((ppre1 & 0x3) + 1)) * 2;
+	}
+	TIM3->CR1 = 0;
+	TIM3->PSC = timClk / 1000000 - 1;						// 1  = 1 
+	TIM3->ARR = 1000000 / KEYBOARD_SCAN_HZ - 1;
+	TIM3->EGR = TIM_EGR_UG;											//  
+	TIM3->SR = 0;
+#ifdef KEYBOARD_SCAN_DMA
+	//  -     BSRR (DMA1 Channel 3),
+	//  CC3   ,    
+	// , -  IDR (DMA1 Channel 2)
+	TIM3->CCR3 = (1000000 / KEYBOARD_SCAN_HZ) / 2;
+	TIM3->DIER = TIM_DIER_UDE | TIM_DIER_CC3DE;
+	dmaChannelInit(DMA_CHANNEL_TIM3_UP, DMA_CCR1_DIR | DMA_CCR1_CIRC | DMA_CCR1_MINC |
+								 DMA_CCR1_PSIZE_1 | DMA_CCR1_MSIZE_1, 0, 0, 0);
+	//  GPIO  ,     
+	dmaChannelInit(DMA_CHANNEL_TIM3_CH3, DMA_CCR1_CIRC | DMA_CCR1_MINC | DMA_CCR1_PSIZE_1,
+								 KEYBOARD_IRQ_PRIORITY, keyboardDmaCallback, 0);
+#else
+	TIM3->DIER = TIM_DIER_UIE;
+	NVIC_SetPriority(TIM3_IRQn, KEYBOARD_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TIM3_IRQn);
+#endif
+	
+	keyboardStartScan();
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @note		  keyboardInit    EXTI/
+	* @param	None
+	* @retval None
+	*/
+static void keyboardStartScan(void) {
+	TIM3->CNT = 0;
+#ifdef KEYBOARD_SCAN_DMA
+	//     ,     
+	dmaChannelConfig(DMA_CHANNEL_TIM3_UP, (uint32_t)&GPIOA->BSRR, (uint32_t)scanColumnPattern, 4);
+	dmaChannelConfig(DMA_CHANNEL_TIM3_CH3, (uint32_t)&GPIOA->IDR, (uint32_t)scanSamples, 8);
+#endif
+	scanCol = 0;
+	setColumn(0);
+	scanRaw = KEY_NONE;
+	scanStable = KEY_NONE;
+	//     KEYBOARD_IDLE_MS,  
+	//        
+	scanActiveTick = scanTick;
+	
+	TIM3->SR = 0;
+	TIM3->CR1 |= TIM_CR1_CEN;
 }
 
+/**
+	******************************************************************************
+	* @brief	       
+	* @note		    0,   
+	*					       EXTI
+	* @param	None
+	* @retval None
+	*/
+static void keyboardEnableWakeup(void) {
+	TIM3->CR1 &= ~TIM_CR1_CEN;
+	GPIOA->BSRR = GPIO_BSRR_BR0 | GPIO_BSRR_BR1 | GPIO_BSRR_BR2 | GPIO_BSRR_BR3;
+	EXTI->PR = KEYBOARD_ROWS_MASK;
+	EXTI->IMR |= KEYBOARD_ROWS_MASK;
+	
+	//        -    
+	if ((GPIOA->IDR & (GPIO_IDR_IDR4 | GPIO_IDR_IDR5 | GPIO_IDR_IDR6 | GPIO_IDR_IDR7)) !=
+			(GPIO_IDR_IDR4 | GPIO_IDR_IDR5 | GPIO_IDR_IDR6 | GPIO_IDR_IDR7)) {
+		EXTI->IMR &= ~KEYBOARD_ROWS_MASK;
+		keyboardStartScan();
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	     (  EXTI4  EXTI9_5)
+	* @param	None
+	* @retval None
+	*/
+static void keyboardWakeIRQHandler(void) {
+	EXTI->IMR &= ~KEYBOARD_ROWS_MASK;			//  -  
+	EXTI->PR = KEYBOARD_ROWS_MASK;
+	keyboardStartScan();
+}
+
+void EXTI4_IRQHandler(void) {
+	keyboardWakeIRQHandler();
+}
+
+void EXTI9_5_IRQHandler(void) {
+	keyboardWakeIRQHandler();
+}
+
+#ifndef KEYBOARD_SCAN_DMA
+/**
+	******************************************************************************
+	* @brief	  :    
+	* @param	None
+	* @retval None
+	*/
+void TIM3_IRQHandler(void) {
+	TIM3->SR = (uint16_t)~TIM_SR_UIF;
+	scanTick += 1000 / KEYBOARD_SCAN_HZ;
+	
+	//  ,     (0   -  )
+	scanRows[scanCol] = (uint8_t)((~GPIOA->IDR >> 4) & 0x0F);
+	
+	//    -      
+	scanCol = (scanCol + 1) & 0x03;
+	setColumn(scanCol);
+	
+	//   
+	if (scanCol == 0) {
+		keyboardScanUpdate(keyboardDecode());
+	}
+}
+#else
+/**
+	******************************************************************************
+	* @brief	  ,  DMA
+	* @param	event	 :   -  0-3,
+	*								 -  4-7
+	* @param	ctx		 
+	* @retval None
+	*/
+static void keyboardDmaCallback(uint8_t event, void *ctx) {
+	if (event & DMA_EVENT_ERROR) {
+		return;
+	}
+	const volatile uint8_t *snapshot = (event & DMA_EVENT_COMPLETE) ? &scanSamples[4] : &scanSamples[0];
+	
+	// 0   -  
+	for (uint8_t col = 0; col < 4; col++) {
+		scanRows[col] = (uint8_t)((~snapshot[col] >> 4) & 0x0F);
+	}
+	scanTick += 4 * (1000 / KEYBOARD_SCAN_HZ);
+	keyboardScanUpdate(keyboardDecode());
+}
+#endif
+
 /**
 	******************************************************************************
 	* @brief	  0   
 	* @param	col		 
 	* @retval None
 	*/
-void setColumn(uint8_t col){
+static void setColumn(uint8_t col){
 	//    (     1
 	GPIOA->BSRR |= GPIO_BSRR_BS0 | GPIO_BSRR_BS1 | GPIO_BSRR_BS2 | GPIO_BSRR_BS3;
 	//   0   
@@ -149,125 +376,166 @@ void setColumn(uint8_t col){
 
 /**
 	******************************************************************************
-	* @brief	  
+	* @brief	       
+	* @note		    -   ,   
 	* @param	None
-	* @retval	 ,     0
+	* @retval	    KEY_NONE
 	*/
-//   
-int readString(){														
-	if ((GPIOA->IDR & GPIO_IDR_IDR4) == 0) return 0;	//  0   0
-	if ((GPIOA->IDR & GPIO_IDR_IDR5) == 0) return 1;	//  0   1
-	if ((GPIOA->IDR & GPIO_IDR_IDR6) == 0) return 2;	//  0   2
-	if ((GPIOA->IDR & GPIO_IDR_IDR7) == 0) return 3;	//  0   3
-	return KEY_NONE; 																	//      0
+static int keyboardDecode(void) {
+	for (uint8_t col = 0; col < 4; col++) {
+		for (uint8_t row = 0; row < 4; row++) {
+			if (scanRows[col] & (1 << row)) {
+				return keyb[row][col];					//   
+			}
+		}
+	}
+	return KEY_NONE;
 }
 
 /**
 	******************************************************************************
-	* @brief	 
-	* @param	None
-	* @retval	  
+	* @brief	,      
+	* @note		     (4  ).
+	*					  KEY_REPEAT_MASK   
+	*					KEY_EVENT_REPEAT  KEY_REPEAT_DELAY_MS   
+	*					KEY_REPEAT_PERIOD_MS,   -  KEY_EVENT_LONG
+	*					 KEY_LONG_MS
+	* @param	btn		    KEY_NONE
+	* @retval None
 	*/
-
-int scanKeyboard(void) {
-	static int bounce = 0;								//  
-	int btn;															//   
-	static int btnOld = 0;								//   
-		
-	//  
-	for (int col = 0; col < 4; col++) {		//  
-		setColumn(col);											//    
-		delayDWT_us(2);
-		btn = readString();									//  
-		if (btn != KEY_NONE)	{							//   
-			btn = keyb[btn][col];							//   
-			break;														//    
+static void keyboardScanUpdate(int btn) {
+	uint32_t now = scanTick;
+	
+	//  ,       
+	keyEventSignal();
+	
+	if (btn != KEY_NONE) {
+		scanActiveTick = now;
+	}
+	
+	// :  ,    KEY_DEBOUNCE_MS
+	if (btn != scanRaw) {
+		scanRaw = btn;
+		scanChangeTick = now;
+	} else if (btn != scanStable && (now - scanChangeTick) >= KEY_DEBOUNCE_MS) {
+		if (scanStable != KEY_NONE) {
+			keyEventPush(KEY_EVENT_UP, scanStable);
+		}
+		scanStable = btn;
+		if (btn != KEY_NONE) {
+			keyEventPush(KEY_EVENT_DOWN, btn);
+			scanPressTick = now;
+			scanRepeatTick = now;
+			scanLongHandled = 0;
 		}
 	}
 	
-	// 
-	if (btn == KEY_NONE || btnOld != btn) {	//        
-		btnOld = btn;													//    
-		bounce = 0;														//   
-		return KEY_NONE;											//    
+	// 
+	if (scanStable != KEY_NONE) {
+		uint32_t held = now - scanPressTick;
+		if (KEY_REPEAT_MASK & (1UL << scanStable)) {
+			if (held >= KEY_REPEAT_DELAY_MS && (now - scanRepeatTick) >= KEY_REPEAT_PERIOD_MS) {
+				scanRepeatTick = now;
+				keyEventPush(KEY_EVENT_REPEAT, scanStable);
+			}
+		} else if (!scanLongHandled && held >= KEY_LONG_MS) {
+			scanLongHandled = 1;
+			keyEventPush(KEY_EVENT_LONG, scanStable);
+		}
+		return;
 	}
-
-	if (bounce == BOUNCE){									//      
-		//bounce++;														//    
-		return btn;														//    
+	
+	//    -    
+	// (     )
+	if ((now - scanActiveTick) >= KEYBOARD_IDLE_MS && keyEventSignal()) {
+		keyboardEnableWakeup();
 	}
+}
 
-	if (bounce < BOUNCE) bounce++;					//     
-
-	return KEY_NONE;												//    
+/**
+	******************************************************************************
+	* @brief	     (  )
+	* @note		   EVENT_KEY (. keyEventSignal).
+	*					     
+	* @param	type	  (KEY_EVENT_*)
+	* @param	key		 
+	* @retval None
+	*/
+static void keyEventPush(uint8_t type, int key) {
+	uint8_t head = keyEventHead;
+	uint8_t next = (head + 1) & (KEY_EVENT_QUEUE_SIZE - 1);
+	if (next == keyEventTail) {
+		return;
+	}
+	keyEventQueue[head].type = type;
+	keyEventQueue[head].key = (uint8_t)key;
+	__DMB();															//     
+	keyEventHead = next;
+	
+	keyEventSignal();
 }
 
 /**
-	* @brief	  
+	******************************************************************************
+	* @brief	      (  )
+	* @note		EVENT_KEY ,     ,  
+	*					   keyboardProcessEvents.   
+	*					  ,    
+	*					,       
 	* @param	None
-	* @retval	  
-	*
-	*         .
-	*       :
-	*   -   (1..16)      >= SHORT_TRESHOLD  ;
-	*   -   + 100         >= LONG_TRESHOLD  ;
-	*   - -1        (   ).
+	* @retval 1 -     , 0 -   
 	*/
-int getKeyPress(void) {
-	static int prev_btn = -2;								//   (  -1)
-	static uint32_t countShort = 0;					//    
-	static uint32_t countLong = 0;					//    
-	static int longHandled = 0;							// :        
-	static int shortHandled = 0;						// :        
-	
-	int btn = scanKeyboard();								//  
-	
-	// 1.       
-	if (btn == KEY_NONE) {
-		prev_btn = KEY_NONE;
-		countShort = 0;
-		countLong = 0;
-		longHandled = 0;
-		shortHandled = 0;
-		return KEY_NONE;
+static uint8_t keyEventSignal(void) {
+	if (keyEventSignaled || keyEventHead == keyEventTail) {
+		return 1;
 	}
-	
-	// 2.    (  )
-	if (btn != prev_btn) {
-		prev_btn = btn;
-		countShort = 1;
-		countLong = 1;
-		longHandled = 0;
-		shortHandled = 0;
-		return KEY_NONE;
+	keyEventSignaled = eventPost(EVENT_PRIO_HIGH, EVENT_KEY, 0);
+	return keyEventSignaled;
+}
+
+/**
+	******************************************************************************
+	* @brief	    
+	* @param	event		 
+	* @retval 1 -  , 0 -  
+	*/
+uint8_t keyboardGetEvent(KeyEvent *event) {
+	uint8_t tail = keyEventTail;
+	if (tail == keyEventHead) {
+		return 0;
 	}
-	// 3.    
-	if (shortHandled) {
-		//  
-		if (longHandled) {
-			//       
-			return KEY_NONE;
-		} 
-		//   
-		countLong++;
-		// 4.    
-		if (countLong >= LONG_TRESHOLD) {
-			longHandled = 1;										// ,   
-			return btn + 100;										//   
+	*event = keyEventQueue[tail];
+	__DMB();															//     
+	keyEventTail = (tail + 1) & (KEY_EVENT_QUEUE_SIZE - 1);
+	return 1;
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @note		     keyboardProcessKey  ,
+	*					  -  + KEY_LONG_OFFSET,   
+	* @param	None
+	* @retval None
+	*/
+void keyboardProcessEvents(void) {
+	KeyEvent event;
+	//   : ,    ,
+	//    (    )
+	keyEventSignaled = 0;
+	while (keyboardGetEvent(&event)) {
+		switch (event.type) {
+			case KEY_EVENT_DOWN:
+			case KEY_EVENT_REPEAT:
+				keyboardProcessKey(event.key);
+				break;
+			case KEY_EVENT_LONG:
+				keyboardProcessKey(event.key + KEY_LONG_OFFSET);
+				break;
+			default:
+				break;
 		}
-		return KEY_NONE;
 	}
-	//      -  
-	countShort++;
-	
-	// 5.    
-	if (countShort >= SHORT_TRESHOLD) {
-		shortHandled = 1;											// ,   
-		return btn;														//   
-		
-	}
-	// 6.    
-	return KEY_NONE;
 }
 
 void ui_init(void) {
@@ -295,6 +563,7 @@ void keyboardProcessKey(int key) {
                 currentState = STATE_SET_TIME;
                 setTimeSubmode = TIME_EDIT_TIME;
                 TimeEditPos = 0;
+                RTCGetTimeDate(&currentTime);	//     
                 tempTime = currentTime;
                 displaySetTime();
             }
@@ -320,6 +589,7 @@ void keyboardProcessKey(int key) {
                 //  
                 currentTime = tempTime;
                 RTCSetTimeDate(&currentTime);
+                eventPost(EVENT_PRIO_HIGH, EVENT_SCHEDULER_CHECK, 0);	//  
                 currentState = STATE_DISPLAY;
                 displayUpdate();
                 break;
@@ -401,6 +671,7 @@ void keyboardProcessKey(int key) {
                 deviceSchedule = scheduleTempTime;
 							schedulerSetOnTime(&deviceSchedule.onTime);
 							schedulerSetOffTime(&deviceSchedule.offTime);
+							eventPost(EVENT_PRIO_HIGH, EVENT_SCHEDULER_CHECK, 0);	//  
                 currentState = STATE_DISPLAY;
                 displayUpdate();
                 break;
@@ -488,97 +759,89 @@ void keyboardProcessKey(int key) {
 
 //     
 static void displayUpdate(void) {
-    lcdClear();
-		lcdCursorOff();
-    char buf[17];
+    lcdClear(LCD_MAIN);
+		lcdCursorOff(LCD_MAIN);
     switch (displayPage) {
         case 0: //  
 					//      lcd.c
             break;
         case 1: //  
-            lcdSetCursor(0, 0);
-            sprintf(buf, "ON: %02d/%02d/%04d", deviceSchedule.onTime.day, deviceSchedule.onTime.month, deviceSchedule.onTime.year);
-            lcdPrintString(buf);
-            lcdSetCursor(1, 4);
-            sprintf(buf, "%02d:%02d:%02d", deviceSchedule.onTime.hours, deviceSchedule.onTime.minutes, deviceSchedule.onTime.seconds);
-            lcdPrintString(buf);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "ON: ");
+            lcdPrintDate(LCD_MAIN, &deviceSchedule.onTime);
+            lcdSetCursor(LCD_MAIN, 1, 4);
+            lcdPrintTime(LCD_MAIN, &deviceSchedule.onTime);
             break;
         case 2: //  
-            lcdSetCursor(0, 0);
-            sprintf(buf, "OFF:%02d/%02d/%04d", deviceSchedule.offTime.day, deviceSchedule.offTime.month, deviceSchedule.offTime.year);
-            lcdPrintString(buf);
-            lcdSetCursor(1,4);
-            sprintf(buf, "%02d:%02d:%02d", deviceSchedule.offTime.hours, deviceSchedule.offTime.minutes, deviceSchedule.offTime.seconds);
-            lcdPrintString(buf);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "OFF:");
+            lcdPrintDate(LCD_MAIN, &deviceSchedule.offTime);
+            lcdSetCursor(LCD_MAIN, 1,4);
+            lcdPrintTime(LCD_MAIN, &deviceSchedule.offTime);
             break;
     }
+    lcdFlush(LCD_MAIN);					//    
 }
 
 //     
 static void displaySetTime(void) {
-    lcdClear();
-    char buf[17];
+    lcdClear(LCD_MAIN);
     if (setTimeSubmode == TIME_EDIT_TIME) {
-			lcdCursorOn();
-        lcdSetCursor(0, 0);
-        lcdPrintString("SET TIME");
-        lcdSetCursor(1, 0);
-        sprintf(buf, "%02d:%02d:%02d", tempTime.hours, tempTime.minutes, tempTime.seconds);
-        lcdPrintString(buf);
+			lcdCursorOn(LCD_MAIN);
+        lcdSetCursor(LCD_MAIN, 0, 0);
+        lcdPrintString(LCD_MAIN, "SET TIME");
+        lcdSetCursor(LCD_MAIN, 1, 0);
+        lcdPrintTime(LCD_MAIN, &tempTime);
         //  
-        lcdSetCursor(1, TimeEditPos * 3);
+        lcdSetCursor(LCD_MAIN, 1, TimeEditPos * 3);
     } else {
-			lcdCursorOn();
-        lcdSetCursor(0, 0);
-        lcdPrintString("SET DATE");
-        lcdSetCursor(1, 0);
-        sprintf(buf, "%02d/%02d/%04d", tempTime.day, tempTime.month, tempTime.year);
-        lcdPrintString(buf);
+			lcdCursorOn(LCD_MAIN);
+        lcdSetCursor(LCD_MAIN, 0, 0);
+        lcdPrintString(LCD_MAIN, "SET DATE");
+        lcdSetCursor(LCD_MAIN, 1, 0);
+        lcdPrintDate(LCD_MAIN, &tempTime);
         // :  (0),  (3),  (6)
-        lcdSetCursor(1, TimeEditPos * 3);
+        lcdSetCursor(LCD_MAIN, 1, TimeEditPos * 3);
     }
+    lcdFlush(LCD_MAIN);					//    
 }
 
 //     
 static void displaySetSchedule(void) {
-    lcdClear();
-    char buf[17];
+    lcdClear(LCD_MAIN);
     switch (scheduleSubmode) {
         case SCHEDULE_EDIT_ON_TIME:
-					lcdCursorOn();
-            lcdSetCursor(0, 0);
-            lcdPrintString("SET ON TIME");
-            lcdSetCursor(1, 0);
-            sprintf(buf, "%02d:%02d:%02d", scheduleTempTime.onTime.hours, scheduleTempTime.onTime.minutes, scheduleTempTime.onTime.seconds);
-            lcdPrintString(buf);
-            lcdSetCursor(1, scheduleEditPos * 3);
+					lcdCursorOn(LCD_MAIN);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "SET ON TIME");
+            lcdSetCursor(LCD_MAIN, 1, 0);
+            lcdPrintTime(LCD_MAIN, &scheduleTempTime.onTime);
+            lcdSetCursor(LCD_MAIN, 1, scheduleEditPos * 3);
             break;
         case SCHEDULE_EDIT_ON_DATE:
-					lcdCursorOn();
-            lcdSetCursor(0, 0);
-            lcdPrintString("SET ON DATE");
-            lcdSetCursor(1, 0);
-            sprintf(buf, "%02d/%02d/%04d", scheduleTempTime.onTime.day, scheduleTempTime.onTime.month, scheduleTempTime.onTime.year);
-            lcdPrintString(buf);
-            lcdSetCursor(1, scheduleEditPos * 3);
+					lcdCursorOn(LCD_MAIN);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "SET ON DATE");
+            lcdSetCursor(LCD_MAIN, 1, 0);
+            lcdPrintDate(LCD_MAIN, &scheduleTempTime.onTime);
+            lcdSetCursor(LCD_MAIN, 1, scheduleEditPos * 3);
             break;
         case SCHEDULE_EDIT_OFF_TIME:
-					lcdCursorOn();
-            lcdSetCursor(0, 0);
-            lcdPrintString("SET OFF TIME");
-            lcdSetCursor(1, 0);
-            sprintf(buf, "%02d:%02d:%02d", scheduleTempTime.offTime.hours, scheduleTempTime.offTime.minutes, scheduleTempTime.offTime.seconds);
-            lcdPrintString(buf);
-            lcdSetCursor(1, scheduleEditPos * 3);
+					lcdCursorOn(LCD_MAIN);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "SET OFF TIME");
+            lcdSetCursor(LCD_MAIN, 1, 0);
+            lcdPrintTime(LCD_MAIN, &scheduleTempTime.offTime);
+            lcdSetCursor(LCD_MAIN, 1, scheduleEditPos * 3);
             break;
         case SCHEDULE_EDIT_OFF_DATE:
-					lcdCursorOn();
-            lcdSetCursor(0, 0);
-            lcdPrintString("SET OFF DATE");
-            lcdSetCursor(1, 0);
-            sprintf(buf, "%02d/%02d/%04d", scheduleTempTime.offTime.day, scheduleTempTime.offTime.month, scheduleTempTime.offTime.year);
-            lcdPrintString(buf);
-            lcdSetCursor(1, scheduleEditPos * 3);
+					lcdCursorOn(LCD_MAIN);
+            lcdSetCursor(LCD_MAIN, 0, 0);
+            lcdPrintString(LCD_MAIN, "SET OFF DATE");
+            lcdSetCursor(LCD_MAIN, 1, 0);
+            lcdPrintDate(LCD_MAIN, &scheduleTempTime.offTime);
+            lcdSetCursor(LCD_MAIN, 1, scheduleEditPos * 3);
             break;
     }
+    lcdFlush(LCD_MAIN);					//    
 }
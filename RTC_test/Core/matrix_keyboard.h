@@ -10,11 +10,44 @@
 
 #include "stm32f10x.h"      			// Device header
 
+/*     (TIM3), .      */
+#define KEYBOARD_SCAN_HZ			1000
+
+/*    :    TIM3  DMA 
+	  GPIOA->BSRR   ,   CC3   
+	    GPIOA->IDR   .  DMA
+	 (/)    4 .
+	   -     TIM3 */
+//#define KEYBOARD_SCAN_DMA
+
+/*    (TIM3  DMA)   (EXTI) */
+#define KEYBOARD_IRQ_PRIORITY	0x0F
+
+/*     ( ) */
+#define KEY_EVENT_QUEUE_SIZE	16
+
+/*    */
+#define KEY_EVENT_DOWN				0			//  ( )
+#define KEY_EVENT_UP					1			// 
+#define KEY_EVENT_LONG				2			//  
+#define KEY_EVENT_REPEAT			3			//   
+
+/*   */
+typedef struct {
+	uint8_t type;									//   (KEY_EVENT_*)
+	uint8_t key;									//   (1..16)
+} KeyEvent;
+
 /*   */
-void keyboardInit(void);
-int scanKeyboard(void);
-int getKeyPress(void);
+void keyboardInit(void);								//     
+uint8_t keyboardGetEvent(KeyEvent*);		//    
+void keyboardProcessEvents(void);				//     
 void keyboardProcessKey(int key);
+#ifndef KEYBOARD_SCAN_DMA
+void TIM3_IRQHandler(void);
+#endif
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
 
 
 #endif /* MATRIX_KEYBOARD_H_ */
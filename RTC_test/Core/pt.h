@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file			pt.h
+  * @brief		:     switch
+  *
+  *  -   PT_THREAD(name(Pt *pt, ...)),  
+  *     ,   
+  *       (  
+  *  pt->lc     case).   
+  *   ,    2 .
+  *
+  * :
+  * -      :  
+  *    static     ;
+  * -       switch;
+  * -        .
+  ******************************************************************************
+  */
+
+#ifndef PT_H
+#define PT_H
+
+#include <stdint.h>
+#include "delay.h"
+
+/*    */
+#define PT_WAITING		0			//   
+#define PT_YIELDED		1			//   (PT_YIELD)
+#define PT_EXITED			2			//   (PT_EXIT)
+#define PT_ENDED			3			//   
+
+/*   */
+typedef struct {
+	uint16_t lc;								//   (0 - )
+} Pt;
+
+/*    */
+#define PT_THREAD(decl)				char decl
+
+/*     */
+#define PT_INIT(pt)						((pt)->lc = 0)
+
+/*      */
+#define PT_BEGIN(pt)					{ char ptYielded = 1; (void)ptYielded; switch ((pt)->lc) { case 0:
+#define PT_END(pt)						} PT_INIT(pt); return PT_ENDED; }
+
+/*    (    ) */
+#define PT_WAIT_UNTIL(pt, cond)	\
+	do { (pt)->lc = __LINE__; case __LINE__: if (!(cond)) { return PT_WAITING; } } while (0)
+#define PT_WAIT_WHILE(pt, cond)	PT_WAIT_UNTIL((pt), !(cond))
+
+/*    (  - PT_WAITING  PT_YIELDED) */
+#define PT_SCHEDULE(f)				((f) < PT_EXITED)
+
+/*     (   ) */
+#define PT_WAIT_THREAD(pt, thread)	PT_WAIT_WHILE((pt), PT_SCHEDULE(thread))
+
+/*          */
+#define PT_SPAWN(pt, child, thread)	\
+	do { PT_INIT(child); PT_WAIT_THREAD((pt), (thread)); } while (0)
+
+/*      */
+#define PT_YIELD(pt)	\
+	do { ptYielded = 0; (pt)->lc = __LINE__; case __LINE__: if (!ptYielded) { return PT_YIELDED; } } while (0)
+
+/*    */
+#define PT_EXIT(pt)						do { PT_INIT(pt); return PT_EXITED; } while (0)
+
+/*      SysTick. start - ,
+	   .  SysTick    
+	 (CYCCNT   WFI ).     
+	   ,   ms + 1  -   ms */
+#define PT_DELAY_MS(pt, start, ms)	\
+	do { (start) = getSysTickCountDelay(); PT_WAIT_UNTIL((pt), delaySysTick_nb_ms((start), (ms) + 1)); } while (0)
+
+#endif	/* PT_H */
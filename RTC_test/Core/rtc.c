@@ -6,15 +6,26 @@
 	*/
 																																	
 #include "stm32f10x.h"                  // Device header
-#include "lcd.h"
+#include "scheduler.h"
+#include "event.h"
 
-extern uint8_t currentState;
-extern uint8_t displayPage;
+//        RTC, 
+#define RTC_RESYNC_PERIOD	3600
 
 //     
 ScheduleTypeDef deviceSchedule = {0};
 RTCTimeDate currentTime = {0};
 
+//   ,      RTC
+static RTCTimeDate rtcCache = {0};
+static volatile uint32_t rtcCacheSeconds = 0;
+static uint16_t rtcTicksSinceSync = RTC_RESYNC_PERIOD;	//     
+
+//      
+static const uint8_t rtcDaysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+static void rtcCacheUpdate(uint32_t seconds);
+
 //    RTC
 void RTCInitClockSource(void) {
     /*    RTC (LSE) */
@@ -178,6 +189,9 @@ void rtcInit(void) {
     RTC->CRL &= ~RTC_CRL_RSF;
     while(!(RTC->CRL & RTC_CRL_RSF));
     
+    //    
+    RTCGetTimeDate(&currentTime);
+    
     // 4.2.    
     RTC->CRH |= RTC_CRH_SECIE;
     
@@ -193,12 +207,19 @@ void rtcInit(void) {
 void RTC_IRQHandler(void) {
     //   
     if(RTC->CRL & RTC_CRL_SECF) {
-			//     
-			if (currentState == 0 && displayPage == 0){
-				RTCGetTimeDate(&currentTime);	//   
-				lcdUpdateTime(&currentTime);	//    
+			//          ,
+			//   RTC_RESYNC_PERIOD  -   
+			if(++rtcTicksSinceSync >= RTC_RESYNC_PERIOD) {
+				rtcCacheUpdate(RTCGetCounter());
+			} else {
+				rtcCacheSeconds++;
+				RTCAdvanceSecond(&rtcCache);
 			}
-			schedulerCheck(); 
+			deviceSchedule.secondsCurrent = rtcCacheSeconds;
+			
+			//      ,    .
+			//   ,       
+			eventPost(EVENT_PRIO_LOW, EVENT_RTC_SECOND, 0);
 			
         //   
         RTC->CRL &= ~RTC_CRL_SECF;
@@ -206,7 +227,11 @@ void RTC_IRQHandler(void) {
     
     //   
     if(RTC->CRL & RTC_CRL_ALRF) {
-        //   
+        //       .
+        //     ,     
+        rtcCacheUpdate(RTCGetCounter());
+        deviceSchedule.secondsCurrent = rtcCacheSeconds;
+        eventPost(EVENT_PRIO_HIGH, EVENT_SCHEDULER_CHECK, 0);
         
         //   
         RTC->CRL &= ~RTC_CRL_ALRF;
@@ -241,6 +266,14 @@ void RTCSetTimeDate(RTCTimeDate *td) {
     
     //   
     while(!(RTC->CRL & RTC_CRL_RTOFF));
+    
+    //     ,    
+    //    ,      
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    rtcCacheUpdate(seconds);
+    rtcTicksSinceSync = RTC_RESYNC_PERIOD;
+    __set_PRIMASK(primask);
 }
 
 //     
@@ -251,16 +284,110 @@ void RTCGetTimeDate(RTCTimeDate* td) {
     RTC->CRL &= ~RTC_CRL_RSF;
     while(!(RTC->CRL & RTC_CRL_RSF));
     
-    //   (   )
-    do {
-        seconds = (RTC->CNTH << 16) | RTC->CNTL;
-    } while(seconds != ((RTC->CNTH << 16) | RTC->CNTL));
+    //  
+    seconds = RTCGetCounter();
+    
+    //         
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    rtcCacheUpdate(seconds);
+    *td = rtcCache;
+    __set_PRIMASK(primask);
 		
 		//           
 		deviceSchedule.secondsCurrent = seconds;
+}
+
+//          RTC
+void RTCGetCachedTimeDate(RTCTimeDate* td) {
+    //    ,      
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *td = rtcCache;
+    __set_PRIMASK(primask);
+}
+
+//     
+uint32_t RTCGetCachedSeconds(void) {
+    return rtcCacheSeconds;
+}
+
+//         , , ,   
+void RTCAdvanceSecond(RTCTimeDate *td) {
+    if(++td->seconds < 60) return;
+    td->seconds = 0;
+    if(++td->minutes < 60) return;
+    td->minutes = 0;
+    if(++td->hours < 24) return;
+    td->hours = 0;
+    
+    //  
+    td->weekday = (td->weekday >= 7) ? 1 : (td->weekday + 1);  // 1-, 7-
+    uint8_t daysInMonth = rtcDaysInMonth[td->month - 1];
+    if(td->month == 2 && RTCIsLeapYear(td->year)) {
+        daysInMonth = 29;
+    }
+    if(++td->day <= daysInMonth) return;
+    td->day = 1;
+    if(++td->month <= 12) return;
+    td->month = 1;
+    td->year++;
+}
+
+//   RTC (   )
+uint32_t RTCGetCounter(void) {
+    uint32_t seconds;
+    do {
+        seconds = (RTC->CNTH << 16) | RTC->CNTL;
+    } while(seconds != ((RTC->CNTH << 16) | RTC->CNTL));
+    return seconds;
+}
+
+//           
+void RTCSetAlarm(uint32_t seconds) {
+    //   RTC  
+    while(!(RTC->CRL & RTC_CRL_RTOFF));
+    
+    //        
+    RTC->CRL |= RTC_CRL_CNF;
+    RTC->ALRH = (seconds >> 16) & 0xFFFF;
+    RTC->ALRL = seconds & 0xFFFF;
+    RTC->CRL &= ~RTC_CRL_CNF;
     
-    //      
-    RTCConvertFromSeconds(seconds, td);
+    //   
+    while(!(RTC->CRL & RTC_CRL_RTOFF));
+    
+    //        
+    RTC->CRL &= ~RTC_CRL_ALRF;
+    RTC->CRH |= RTC_CRH_ALRIE;
+}
+
+//   
+void RTCDisableAlarm(void) {
+    RTC->CRH &= ~RTC_CRH_ALRIE;
+    RTC->CRL &= ~RTC_CRL_ALRF;
+}
+
+// /  
+void RTCSetSecondInterrupt(uint8_t enable) {
+    if(enable) {
+        if(!(RTC->CRH & RTC_CRH_SECIE)) {
+            //    ,    -
+            //    
+            rtcTicksSinceSync = RTC_RESYNC_PERIOD;
+            RTC->CRL &= ~RTC_CRL_SECF;
+            RTC->CRH |= RTC_CRH_SECIE;
+        }
+    } else {
+        RTC->CRH &= ~RTC_CRH_SECIE;
+    }
+}
+
+//       (       RTC)
+static void rtcCacheUpdate(uint32_t seconds) {
+    rtcCacheSeconds = seconds;
+    RTCConvertFromSeconds(seconds, &rtcCache);
+    rtcTicksSinceSync = 0;
 }
 
 //   
@@ -272,32 +399,25 @@ uint8_t RTCIsLeapYear(uint16_t year) {
 }
 
 //      
+//    01.01.1970     ( days_from_civil):
+//     1 ,    -   ,
+//          (153 * m + 2) / 5.
+//    400-  ()  146097 .
+//     ,   
+//     .
 uint32_t RTCConvertToSeconds(RTCTimeDate *td) {
-    uint32_t totalDays = 0;
-    uint16_t year;
-    uint8_t month;
-    
-    //      
-    for(year = 1970; year < td->year; year++) {
-        totalDays += RTCIsLeapYear(year) ? 366 : 365;
-    }
-    
-    //       
-    const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 
-                                     31, 31, 30, 31, 30, 31};
+    // ,   :       
+    uint32_t year = td->year - (td->month <= 2);
+    // ,    ( = 0, ...,  = 11)
+    uint32_t month = (td->month > 2) ? (td->month - 3) : (td->month + 9);
     
-    //         
-    for(month = 1; month < td->month; month++) {
-        totalDays += daysInMonth[month - 1];
-        
-        //      
-        if(month == 2 && RTCIsLeapYear(td->year)) {
-            totalDays += 1;
-        }
-    }
+    uint32_t era = year / 400;                                 //  400- 
+    uint32_t yearOfEra = year - era * 400;                     // [0, 399]
+    uint32_t dayOfYear = (153 * month + 2) / 5 + td->day - 1;  // [0, 365]
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear; // [0, 146096]
     
-    //     (-1, ..  1 )
-    totalDays += (td->day - 1);
+    // 719468 -    01.03.0000  01.01.1970
+    uint32_t totalDays = era * 146097 + dayOfEra - 719468;
     
     //    
     uint32_t totalSeconds = totalDays * 86400UL;  //   
@@ -309,10 +429,10 @@ uint32_t RTCConvertToSeconds(RTCTimeDate *td) {
 }
 
 //      
+//         ( civil_from_days),
+//  RTCConvertToSeconds
 void RTCConvertFromSeconds(uint32_t seconds, RTCTimeDate *td) {
     uint32_t days, remainingSeconds;
-    uint16_t year = 1970;
-    uint8_t month;
     uint8_t dayOfWeek;
     
     //   
@@ -323,40 +443,18 @@ void RTCConvertFromSeconds(uint32_t seconds, RTCTimeDate *td) {
     dayOfWeek = (days + 4) % 7;  // 0=, 1=...
     td->weekday = (dayOfWeek == 0) ? 7 : dayOfWeek;  // 1-, 7-
     
-    //  
-    while(1) {
-        uint16_t daysInYear = RTCIsLeapYear(year) ? 366 : 365;
-        
-        if(days < daysInYear) {
-            break;
-        }
-        
-        days -= daysInYear;
-        year++;
-    }
-    
-    td->year = year;
+    //   01.03.0000
+    days += 719468;
+    uint32_t era = days / 146097;                              //  400- 
+    uint32_t dayOfEra = days - era * 146097;                   // [0, 146096]
+    //        ( 4, 100  400 )
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365; // [0, 399]
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);        // [0, 365]
+    uint32_t month = (5 * dayOfYear + 2) / 153;                //    [0, 11]
     
-    //       
-    const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 
-																		31, 31, 30, 31, 30, 31};
-    
-    //     
-    uint8_t daysInFeb = RTCIsLeapYear(year) ? 29 : 28;
-    
-    //  
-    for(month = 1; month <= 12; month++) {
-        uint8_t daysThisMonth = (month == 2) ? daysInFeb : daysInMonth[month - 1];
-        
-        if(days < daysThisMonth) {
-            break;
-        }
-        
-        days -= daysThisMonth;
-    }
-    
-    td->month = month;
-    td->day = days + 1;  // +1      0
+    td->day = dayOfYear - (153 * month + 2) / 5 + 1;          // [1, 31]
+    td->month = (month < 10) ? (month + 3) : (month - 9);     // [1, 12]
+    td->year = yearOfEra + era * 400 + (td->month <= 2);
     
     //  
     td->hours = remainingSeconds / 3600;
@@ -364,7 +462,3 @@ void RTCConvertFromSeconds(uint32_t seconds, RTCTimeDate *td) {
     td->minutes = remainingSeconds / 60;
     td->seconds = remainingSeconds % 60;
 }
-
-
-
-
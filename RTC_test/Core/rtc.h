@@ -35,7 +35,14 @@ typedef struct {
 /*   */
 void rtcInit(void);											//  RTC
 void RTCSetTimeDate(RTCTimeDate *td);
-void RTCGetTimeDate(RTCTimeDate *td);
+void RTCGetTimeDate(RTCTimeDate *td);						//     RTC   
+void RTCGetCachedTimeDate(RTCTimeDate *td);				//       RTC
+uint32_t RTCGetCachedSeconds(void);								//    
+void RTCAdvanceSecond(RTCTimeDate *td);						//     
+uint32_t RTCGetCounter(void);											//   RTC  
+void RTCSetAlarm(uint32_t seconds);								//  
+void RTCDisableAlarm(void);												//  
+void RTCSetSecondInterrupt(uint8_t enable);				// /  
 uint8_t RTCIsLeapYear(uint16_t year);
 uint32_t RTCConvertToSeconds(RTCTimeDate *td);
 void RTCConvertFromSeconds(uint32_t seconds, RTCTimeDate *td);
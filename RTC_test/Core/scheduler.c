@@ -6,19 +6,25 @@
   *       
   *       GPIO.
   *   - .
+  *     ,    RTC,
+  *    .
   ******************************************************************************
   */
 
 #include "scheduler.h"
 #include "stm32f10x.h"                  		// Device header
 #include "gpio.h"
+#include "event.h"
 
 extern ScheduleTypeDef deviceSchedule;			//    rtc.c
 static uint8_t schedulerState = 0;						//   
 static uint8_t deviceState = 0;							//   
 
+static void schedulerArmAlarm(void);
+
 /**
-  * @brief      
+  * @brief   ,    
+  *          RTC   
   * @param  None
   * @retval None
   */
@@ -30,7 +36,33 @@ void schedulerCheck(void) {
 	} else {
 		deviceOff();
 	}
+	schedulerArmAlarm();
+}
 
+/**
+  * @brief    RTC    
+  * @param  None
+  * @retval None
+  */
+static void schedulerArmAlarm(void) {
+	uint32_t next;
+	
+	if (deviceSchedule.secondsCurrent < deviceSchedule.secondsOn) {
+		next = deviceSchedule.secondsOn;					//  
+	} else if (deviceSchedule.secondsCurrent < deviceSchedule.secondsOff) {
+		next = deviceSchedule.secondsOff;					//  
+	} else {
+		RTCDisableAlarm();												//  
+		return;
+	}
+	
+	RTCSetAlarm(next);
+	
+	//       ,  
+	//   -     
+	if (RTCGetCounter() >= next) {
+		eventPost(EVENT_PRIO_HIGH, EVENT_SCHEDULER_CHECK, 0);
+	}
 }
 void deviceOn (void) {
 	if (deviceState != DEVICE_ON) {
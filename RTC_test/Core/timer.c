@@ -0,0 +1,193 @@
+/**
+	******************************************************************************
+	* @file			timer.c
+	* @brief		    (hashed timing wheel)  SysTick
+	*
+	*     expires    
+	* expires % TIMER_WHEEL_SIZE.    -   
+	*     O(1). timerProcess    SysTick
+	*    ,    
+	*      (    
+	* ,      ).
+	*
+	*        ( ..  
+	* ),    .
+	******************************************************************************
+	*/
+
+#include "timer.h"
+#include "delay.h"
+
+#ifndef SYSTICK_DELAY_ENABLE
+#error "   SysTick:  SYSTICK_DELAY_ENABLE  delay.h"
+#endif
+
+#if (TIMER_WHEEL_SIZE & (TIMER_WHEEL_SIZE - 1)) != 0
+#error "TIMER_WHEEL_SIZE    "
+#endif
+
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SIZE - 1)
+
+static SoftTimer *timerWheel[TIMER_WHEEL_SIZE];	//    
+static uint32_t timerCurrentTick;								//   
+
+static void timerLink(SoftTimer **head, SoftTimer *t);
+static void timerUnlink(SoftTimer *t);
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @note		  SysTickDelay_Init
+	* @param	None
+	* @retval None
+	*/
+void timerInit(void) {
+	for (uint16_t i = 0; i < TIMER_WHEEL_SIZE; i++) {
+		timerWheel[i] = 0;
+	}
+	timerCurrentTick = getSysTickCountDelay();
+}
+
+/**
+	******************************************************************************
+	* @brief	 ( ) 
+	* @param	t					
+	* @param	delay			      (0 -  1 )
+	* @param	period		   , 0 -  
+	* @param	callback	 
+	* @param	ctx				  
+	* @retval None
+	*/
+void timerStart(SoftTimer *t, uint32_t delay, uint32_t period, TimerCallback callback, void *ctx) {
+	timerStop(t);
+
+	if (delay == 0) {
+		delay = 1;				//      
+	}
+	t->expires = getSysTickCountDelay() + delay;
+	t->period = period;
+	t->callback = callback;
+	t->ctx = ctx;
+	timerLink(&timerWheel[t->expires & TIMER_WHEEL_MASK], t);
+}
+
+/**
+	******************************************************************************
+	* @brief	 
+	* @note		         
+	* @param	t		
+	* @retval None
+	*/
+void timerStop(SoftTimer *t) {
+	if (t->pprev != 0) {
+		timerUnlink(t);
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	,   
+	* @param	t		
+	* @retval 1 -  , 0 - 
+	*/
+uint8_t timerIsActive(const SoftTimer *t) {
+	return (t->pprev != 0);
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @note		   .   , 
+	*					   ,    
+	* @param	None
+	* @retval None
+	*/
+void timerProcess(void) {
+	uint32_t now = getSysTickCountDelay();
+
+	while (timerCurrentTick != now) {
+		timerCurrentTick++;
+
+		//       ,   
+		//       
+		SoftTimer *expired = 0;
+		SoftTimer *t = timerWheel[timerCurrentTick & TIMER_WHEEL_MASK];
+		while (t != 0) {
+			SoftTimer *next = t->next;
+			if (t->expires == timerCurrentTick) {
+				timerUnlink(t);
+				timerLink(&expired, t);
+			}
+			t = next;
+		}
+
+		while (expired != 0) {
+			t = expired;
+			timerUnlink(t);
+			if (t->period != 0) {
+				//     ,     
+				t->expires += t->period;
+				timerLink(&timerWheel[t->expires & TIMER_WHEEL_MASK], t);
+			}
+			t->callback(t->ctx);
+		}
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	   
+	* @note		      : 
+	*					  i      i , 
+	*					 ,       i.
+	*					    
+	* @param	None
+	* @retval   ,    -
+	*					  + TIMER_IDLE_MAX
+	*/
+uint32_t timerNextExpiry(void) {
+	uint32_t nearest = TIMER_IDLE_MAX;
+
+	for (uint32_t i = 1; i <= TIMER_WHEEL_SIZE && i < nearest; i++) {
+		SoftTimer *t = timerWheel[(timerCurrentTick + i) & TIMER_WHEEL_MASK];
+		while (t != 0) {
+			uint32_t delta = t->expires - timerCurrentTick;
+			if (delta < nearest) {
+				nearest = delta;
+			}
+			t = t->next;
+		}
+	}
+	return timerCurrentTick + nearest;
+}
+
+/**
+	******************************************************************************
+	* @brief	    
+	* @param	head	 
+	* @param	t			
+	* @retval None
+	*/
+static void timerLink(SoftTimer **head, SoftTimer *t) {
+	t->next = *head;
+	if (*head != 0) {
+		(*head)->pprev = &t->next;
+	}
+	*head = t;
+	t->pprev = head;
+}
+
+/**
+	******************************************************************************
+	* @brief	   ,    
+	* @param	t		
+	* @retval None
+	*/
+static void timerUnlink(SoftTimer *t) {
+	*t->pprev = t->next;
+	if (t->next != 0) {
+		t->next->pprev = t->pprev;
+	}
+	t->next = 0;
+	t->pprev = 0;
+}
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file			timer.h
+  * @brief		    
+  ******************************************************************************
+  */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "stm32f10x.h"
+
+/*     ( ), 1  = 1  SysTick (1 ) */
+#define TIMER_WHEEL_SIZE			256
+
+/*        ,  */
+#define TIMER_IDLE_MAX				1000
+
+/*   (     timerProcess) */
+typedef void (*TimerCallback)(void *ctx);
+
+/*  .    (static  
+   ),      */
+typedef struct SoftTimer {
+	struct SoftTimer *next;						//     
+	struct SoftTimer **pprev;					//      
+	uint32_t expires;									//  
+	uint32_t period;									//   , 0 -  
+	TimerCallback callback;						//  
+	void *ctx;												//   
+} SoftTimer;
+
+/*   */
+void timerInit(void);																		//   
+void timerStart(SoftTimer *, uint32_t, uint32_t, TimerCallback, void *);	//  
+void timerStop(SoftTimer *);														//  
+uint8_t timerIsActive(const SoftTimer *);								// ,   
+void timerProcess(void);																//    ( )
+uint32_t timerNextExpiry(void);													//    (   )
+
+#endif	/* TIMER_H */
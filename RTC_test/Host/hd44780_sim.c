@@ -0,0 +1,367 @@
+/**
+	******************************************************************************
+	* @file			hd44780_sim.c
+	* @brief		 HD44780   PCF8574 (  )
+	*
+	*     ,  lcd.c   PCF8574:   -
+	*   P0-P7 (RS, R/W, E, , D4-D7).   E
+	*   ,  4-   
+	*     .  R/W = 1  E = 1  
+	* ,      (BF   )
+	*  ,    PCF8574.  R/W    ,
+	*    E,      tAS.
+	*   R/W,   GND (rwGrounded),  
+	*   ,  PCF8574   .
+	*
+	*     I2C: ,     
+	*  9  SCL,  - 1 .    
+	*      (BF = 1). ,  
+	* BF = 1, ,    :  
+	*     .
+	******************************************************************************
+	*/
+
+#include "hd44780_sim.h"
+#include <string.h>
+
+/*     (16x2: 0x00, 0x40; 20x4: + 0x14, 0x54) */
+static const uint8_t simRowAddr[4] = {0x00, 0x40, 0x14, 0x54};
+
+static void simPortWrite(HdSim *sim, uint8_t value);
+static uint8_t simPortRead(const HdSim *sim);
+static void simExecute(HdSim *sim, uint8_t value, uint8_t rs);
+static void simCommand(HdSim *sim, uint8_t cmd);
+static void simAddressStep(HdSim *sim);
+static uint8_t simReadRegister(const HdSim *sim, uint8_t rs);
+static uint64_t simBitNs(const HdSim *sim);
+
+/**
+	******************************************************************************
+	* @brief	 
+	* @param	sim		
+	* @param	i2cHz	 SCL, 
+	* @retval	None
+	* @note		 DDRAM - , CGRAM   ( 0xFF)
+	******************************************************************************
+	*/
+void hdSimReset(HdSim *sim, uint32_t i2cHz) {
+	memset(sim, 0, sizeof(*sim));
+	sim->i2cHz = i2cHz;
+	sim->port = 0xFF;
+	memset(sim->ddram, ' ', sizeof(sim->ddram));
+	memset(sim->cgram, 0xFF, sizeof(sim->cgram));
+	sim->mode8bit = 1;
+	sim->entryInc = 1;
+	sim->busyUntil = SIM_POWER_ON_NS;
+}
+
+/**
+	******************************************************************************
+	* @brief	  (    )
+	* @param	sim		
+	* @retval	None
+	******************************************************************************
+	*/
+void hdSimStatsReset(HdSim *sim) {
+	sim->transactions = 0;
+	sim->busBytes = 0;
+	sim->commands = 0;
+	sim->dataWrites = 0;
+	sim->cgramWrites = 0;
+	sim->busyViolations = 0;
+	sim->setupViolations = 0;
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @param	sim		
+	* @param	ns		, 
+	* @retval	None
+	******************************************************************************
+	*/
+void hdSimAdvance(HdSim *sim, uint64_t ns) {
+	sim->now += ns;
+}
+
+/**
+	******************************************************************************
+	* @brief	   PCF8574
+	* @param	sim		
+	* @param	data	  
+	* @param	len		 
+	* @retval	None
+	* @note		 PCF8574     
+	******************************************************************************
+	*/
+void hdSimI2CWrite(HdSim *sim, const uint8_t *data, uint16_t len) {
+	uint64_t bit = simBitNs(sim);
+	
+	sim->transactions++;
+	sim->now += 9 * bit;									//   
+	for (uint16_t i = 0; i < len; i++) {
+		sim->now += 9 * bit;
+		simPortWrite(sim, data[i]);
+	}
+	sim->now += bit;										// 
+	sim->busBytes += len;
+}
+
+/**
+	******************************************************************************
+	* @brief	  PCF8574
+	* @param	sim		
+	* @param	data	  
+	* @param	len		 
+	* @retval	None
+	* @note		      
+	******************************************************************************
+	*/
+void hdSimI2CRead(HdSim *sim, uint8_t *data, uint16_t len) {
+	uint64_t bit = simBitNs(sim);
+	
+	sim->transactions++;
+	sim->now += 9 * bit;
+	for (uint16_t i = 0; i < len; i++) {
+		data[i] = simPortRead(sim);
+		sim->now += 9 * bit;
+	}
+	sim->now += bit;
+	sim->busBytes += len;
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @param	sim		
+	* @param	row		 (0-3)
+	* @param	cols	 
+	* @param	buf		   cols + 1 
+	* @retval	None
+	* @note		  ( 0-7)   '0'-'7'
+	******************************************************************************
+	*/
+void hdSimGetRow(const HdSim *sim, uint8_t row, uint8_t cols, char *buf) {
+	uint8_t base = simRowAddr[row & 3];
+	uint8_t line = base & 0x40;
+	
+	for (uint8_t col = 0; col < cols; col++) {
+		int offset = ((base & 0x3F) + col + sim->shift) % 40;
+		if (offset < 0) {
+			offset += 40;
+		}
+		uint8_t c = sim->ddram[line + offset];
+		buf[col] = (c < 8) ? (char)('0' + c) : (char)c;
+	}
+	buf[cols] = '\0';
+}
+
+/**
+	******************************************************************************
+	* @brief	  SCL
+	* @param	sim		
+	* @retval	, 
+	******************************************************************************
+	*/
+static uint64_t simBitNs(const HdSim *sim) {
+	return 1000000000ULL / sim->i2cHz;
+}
+
+/**
+	******************************************************************************
+	* @brief	   PCF8574
+	* @param	sim		
+	* @param	value	  
+	* @retval	None
+	******************************************************************************
+	*/
+static void simPortWrite(HdSim *sim, uint8_t value) {
+	uint8_t fall = (sim->port & SIM_E) && !(value & SIM_E);
+	uint8_t rise = !(sim->port & SIM_E) && (value & SIM_E);
+	uint8_t nibble = value >> 4;
+	
+	if (rise && ((sim->port ^ value) & SIM_RW)) {
+		sim->setupViolations++;
+	}
+	sim->port = value;
+	if (!fall) {
+		return;
+	}
+	if (sim->rwGrounded) {
+		value &= (uint8_t)~SIM_RW;
+	}
+	
+	// :  E   
+	if (value & SIM_RW) {
+		if (sim->mode8bit) {
+			return;
+		}
+		sim->nibbleLow ^= 1;
+		if (!sim->nibbleLow && (value & SIM_RS)) {
+			simAddressStep(sim);
+		}
+		return;
+	}
+	
+	// :  8-   D0-D3   (  0)
+	if (sim->mode8bit) {
+		simExecute(sim, (uint8_t)(nibble << 4), value & SIM_RS);
+		return;
+	}
+	if (!sim->nibbleLow) {
+		sim->nibbleHigh = nibble;
+		sim->nibbleLow = 1;
+		return;
+	}
+	sim->nibbleLow = 0;
+	simExecute(sim, (uint8_t)((sim->nibbleHigh << 4) | nibble), value & SIM_RS);
+}
+
+/**
+	******************************************************************************
+	* @brief	  PCF8574
+	* @param	sim		
+	* @retval	 
+	* @note		   1 - ,   
+	*					,  R/W = 1  E = 1
+	******************************************************************************
+	*/
+static uint8_t simPortRead(const HdSim *sim) {
+	if (sim->rwGrounded || !((sim->port & SIM_RW) && (sim->port & SIM_E))) {
+		return sim->port;
+	}
+	uint8_t reg = simReadRegister(sim, sim->port & SIM_RS);
+	uint8_t nibble = sim->nibbleLow ? (reg & 0x0F) : (reg >> 4);
+	return (uint8_t)((sim->port & 0x0F) | (sim->port & (nibble << 4)));
+}
+
+/**
+	******************************************************************************
+	* @brief	,    
+	* @param	sim		
+	* @param	rs		0 -   (BF   ), 1 - 
+	* @retval	 
+	******************************************************************************
+	*/
+static uint8_t simReadRegister(const HdSim *sim, uint8_t rs) {
+	if (rs) {
+		return sim->acCgram ? sim->cgram[sim->ac & 0x3F] : sim->ddram[sim->ac & 0x7F];
+	}
+	return (uint8_t)(((sim->now < sim->busyUntil) ? 0x80 : 0x00) | (sim->ac & 0x7F));
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @param	sim		
+	* @param	value	
+	* @param	rs		0 - , 1 - 
+	* @retval	None
+	******************************************************************************
+	*/
+static void simExecute(HdSim *sim, uint8_t value, uint8_t rs) {
+	if (sim->now < sim->busyUntil) {
+		sim->busyViolations++;
+	}
+	sim->busyUntil = sim->now + SIM_EXEC_NS;
+	
+	if (!rs) {
+		sim->commands++;
+		simCommand(sim, value);
+		return;
+	}
+	sim->dataWrites++;
+	if (sim->acCgram) {
+		sim->cgram[sim->ac & 0x3F] = value & 0x1F;
+		sim->cgramWrites++;
+	} else {
+		sim->ddram[sim->ac & 0x7F] = value;
+	}
+	simAddressStep(sim);
+}
+
+/**
+	******************************************************************************
+	* @brief	 
+	* @param	sim		
+	* @param	cmd		 
+	* @retval	None
+	******************************************************************************
+	*/
+static void simCommand(HdSim *sim, uint8_t cmd) {
+	if (cmd & 0x80) {												//   DDRAM
+		sim->ac = cmd & 0x7F;
+		sim->acCgram = 0;
+	} else if (cmd & 0x40) {								//   CGRAM
+		sim->ac = cmd & 0x3F;
+		sim->acCgram = 1;
+	} else if (cmd & 0x20) {								//  
+		if (sim->mode8bit) {
+			sim->busyUntil = sim->now + SIM_EXEC_SYNC_NS;
+		}
+		sim->mode8bit = (cmd & 0x10) ? 1 : 0;
+		sim->lines2 = (cmd & 0x08) ? 1 : 0;
+		sim->nibbleLow = 0;
+	} else if (cmd & 0x10) {								//    
+		int8_t dir = (cmd & 0x04) ? 1 : -1;
+		if (cmd & 0x08) {
+			sim->shift = (int8_t)((sim->shift - dir) % 40);
+		} else {
+			sim->ac = (uint8_t)(sim->ac + dir);
+		}
+	} else if (cmd & 0x08) {								//  
+		sim->displayOn = (cmd & 0x04) ? 1 : 0;
+		sim->cursorOn = (cmd & 0x02) ? 1 : 0;
+		sim->blinkOn = (cmd & 0x01) ? 1 : 0;
+	} else if (cmd & 0x04) {								//  
+		sim->entryInc = (cmd & 0x02) ? 1 : 0;
+	} else if (cmd & 0x02) {								// 
+		sim->ac = 0;
+		sim->acCgram = 0;
+		sim->shift = 0;
+		sim->busyUntil = sim->now + SIM_EXEC_LONG_NS;
+	} else if (cmd & 0x01) {								// 
+		memset(sim->ddram, ' ', sizeof(sim->ddram));
+		sim->ac = 0;
+		sim->acCgram = 0;
+		sim->shift = 0;
+		sim->entryInc = 1;
+		sim->busyUntil = sim->now + SIM_EXEC_LONG_NS;
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	       
+	* @param	sim		
+	* @retval	None
+	* @note		   DDRAM -    40 :
+	*					0x00-0x27  0x40-0x67,    
+	******************************************************************************
+	*/
+static void simAddressStep(HdSim *sim) {
+	if (sim->acCgram) {
+		sim->ac = (uint8_t)((sim->ac + (sim->entryInc ? 1 : -1)) & 0x3F);
+		return;
+	}
+	if (!sim->lines2) {
+		sim->ac = (uint8_t)((sim->ac + (sim->entryInc ? 1 : 79)) % 80);
+		return;
+	}
+	if (sim->entryInc) {
+		sim->ac++;
+		if (sim->ac == 0x28) {
+			sim->ac = 0x40;
+		} else if (sim->ac == 0x68) {
+			sim->ac = 0x00;
+		}
+	} else {
+		if (sim->ac == 0x00) {
+			sim->ac = 0x67;
+		} else if (sim->ac == 0x40) {
+			sim->ac = 0x27;
+		} else {
+			sim->ac--;
+		}
+	}
+}
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file			hd44780_sim.h
+  * @brief		   HD44780   PCF8574
+  ******************************************************************************
+  */
+
+#ifndef HD44780_SIM_H
+#define HD44780_SIM_H
+
+#include <stdint.h>
+
+/*   PCF8574 (  lcd.h) */
+#define SIM_RS						0x01
+#define SIM_RW						0x02
+#define SIM_E							0x04
+#define SIM_BL						0x08
+
+/*    ,  (HD44780U, fosc = 270 ) */
+#define SIM_EXEC_NS				37000ULL			//     
+#define SIM_EXEC_LONG_NS	1520000ULL		//   
+#define SIM_EXEC_SYNC_NS	4100000ULL		//    8-  ()
+#define SIM_POWER_ON_NS		40000000ULL		//    
+
+#define SIM_DDRAM_SIZE		0x80
+#define SIM_CGRAM_SIZE		0x40
+
+/*   */
+typedef struct {
+	//  I2C
+	uint32_t i2cHz;									//  SCL
+	uint64_t now;										//  , 
+	uint8_t port;										//  PCF8574
+	uint8_t rwGrounded;							// 1 -  R/W    GND ( P1)
+	
+	//  HD44780
+	uint8_t ddram[SIM_DDRAM_SIZE];	//   ( = )
+	uint8_t cgram[SIM_CGRAM_SIZE];	// : 8  x 8 
+	uint8_t ac;											//  
+	uint8_t acCgram;								// 1 -     CGRAM
+	uint8_t mode8bit;								// 1 - 8-  ( )
+	uint8_t lines2;									// 1 -   (N)
+	uint8_t nibbleLow;							// 1 -   
+	uint8_t nibbleHigh;							//   
+	uint8_t entryInc;								// I/D: 1 -  
+	uint8_t displayOn;							// D
+	uint8_t cursorOn;								// C
+	uint8_t blinkOn;								// B
+	int8_t shift;										//  
+	uint64_t busyUntil;							//   BF
+	
+	// 
+	uint32_t transactions;					//  I2C
+	uint32_t busBytes;							//     ( )
+	uint32_t commands;							//  
+	uint32_t dataWrites;						//    DDRAM/CGRAM
+	uint32_t cgramWrites;						//    CGRAM
+	uint32_t busyViolations;				// ,   BF = 1 ( )
+	uint32_t setupViolations;				//  E    R/W ( tAS)
+} HdSim;
+
+/*   */
+void hdSimReset(HdSim *, uint32_t);											//  
+void hdSimI2CWrite(HdSim *, const uint8_t *, uint16_t);	//    PCF8574
+void hdSimI2CRead(HdSim *, uint8_t *, uint16_t);				//   PCF8574
+void hdSimAdvance(HdSim *, uint64_t);										//  , 
+void hdSimGetRow(const HdSim *, uint8_t, uint8_t, char *);	//   
+void hdSimStatsReset(HdSim *);													//  
+
+#endif	/* HD44780_SIM_H */
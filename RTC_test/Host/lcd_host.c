@@ -0,0 +1,348 @@
+/**
+	******************************************************************************
+	* @file			lcd_host.c
+	* @brief		 lcd.c     HD44780 + PCF8574
+	*
+	*  lcd.c   .  i2c*,  DWT
+	*  SysTick     :  I2C
+	*  ,  DWT (72 )   SysTick
+	*    .
+	*         
+	*        ,  
+	*       .
+	*
+	*    (  RTC_test):
+	*		gcc -std=c99 -Wall -IHost -ICore Host/lcd_host.c Host/hd44780_sim.c \
+	*			Core/lcd.c Core/fmt.c -o lcd_host && ./lcd_host
+	*  -DLCD_COUNT=2     (20x4)   
+	* .   0 -   .
+	*
+	*     CP1251:     
+	* UTF-8  ./lcd_host | iconv -f cp1251.
+	******************************************************************************
+	*/
+
+#include <stdio.h>
+#include <string.h>
+#include "hd44780_sim.h"
+#include "lcd.h"
+
+#define HOST_IDLE_NS			1000ULL			//     
+
+static HdSim hostSim[LCD_COUNT];				//    
+static uint64_t hostNow = 0;						//   , 
+static uint8_t hostSchedulerOn = 0;
+static uint8_t hostDeviceOn = 0;
+static int hostFailures = 0;
+
+/**
+	******************************************************************************
+	*											  
+	******************************************************************************
+	*/
+void hostIdle(void) {
+	hostNow += HOST_IDLE_NS;
+}
+
+uint32_t getDWTCountDelay(void) {
+	return (uint32_t)(hostNow * (DELAY_CYCLES_PER_US) / 1000ULL);
+}
+
+uint8_t delayDWT_nb_ms(uint32_t start, uint32_t ms) {
+	return (getDWTCountDelay() - start) >= ms * DELAY_CYCLES_PER_MS;
+}
+
+void delayDWT_ms(uint32_t ms) {
+	hostNow += (uint64_t)ms * 1000000ULL;
+}
+
+uint32_t getSysTickCountDelay(void) {
+	return (uint32_t)(hostNow / 1000000ULL);
+}
+
+uint8_t delaySysTick_nb_ms(uint32_t start, uint32_t ms) {
+	return (getSysTickCountDelay() - start) >= ms;
+}
+
+uint8_t getSchedulerState(void) {
+	return hostSchedulerOn;
+}
+
+uint8_t getDeviceState(void) {
+	return hostDeviceOn;
+}
+
+void i2cWriteOpInit(I2COp *op, uint8_t addr, const uint8_t *data, uint16_t len) {
+	op->addr = addr;
+	op->data = data;
+	op->rxData = 0;
+	op->len = len;
+	PT_INIT(&op->pt);
+}
+
+void i2cWriteByteOpInit(I2COp *op, uint8_t addr, uint8_t data) {
+	op->byte = data;
+	i2cWriteOpInit(op, addr, &op->byte, 1);
+}
+
+void i2cReadOpInit(I2COp *op, uint8_t addr, uint8_t *data, uint16_t len) {
+	i2cWriteOpInit(op, addr, 0, len);
+	op->rxData = data;
+}
+
+//   :       .
+//        
+PT_THREAD(i2cTransferThread(I2COp *op)) {
+	op->status = I2C_STATUS_NACK;
+	for (uint8_t i = 0; i < LCD_COUNT; i++) {
+		if (op->addr != LCD_DISPLAY(i)->address) {
+			continue;
+		}
+		HdSim *sim = &hostSim[i];
+		sim->now = hostNow;
+		if (op->rxData) {
+			hdSimI2CRead(sim, op->rxData, op->len);
+		} else {
+			hdSimI2CWrite(sim, op->data, op->len);
+		}
+		hostNow = sim->now;
+		op->status = I2C_STATUS_OK;
+	}
+	return PT_ENDED;
+}
+
+void i2cWriteBuffer(uint8_t addr, const uint8_t *data, uint16_t len) {
+	I2COp op;
+	i2cWriteOpInit(&op, addr, data, len);
+	i2cTransferThread(&op);
+}
+
+void i2cWriteByte(uint8_t addr, uint8_t data) {
+	i2cWriteBuffer(addr, &data, 1);
+}
+
+/**
+	******************************************************************************
+	*											
+	******************************************************************************
+	* @brief	     
+	* @param	n			 
+	* @param	name	 
+	* @param	rows	  (   )
+	* @retval	None
+	*/
+static void hostExpectScreen(uint8_t n, const char *name, const char *const *rows) {
+	LcdDisplay *lcd = LCD_DISPLAY(n);
+	char buf[LCD_MAX_COLS + 1];
+	int ok = 1;
+	
+	printf("%-24s", name);
+	for (uint8_t row = 0; row < lcd->rows; row++) {
+		hdSimGetRow(&hostSim[n], row, lcd->cols, buf);
+		ok &= (strcmp(buf, rows[row]) == 0);
+		printf(" |%s|", buf);
+	}
+	printf("  %s\n", ok ? "OK" : "FAIL");
+	if (!ok) {
+		printf("%-24s", "");
+		for (uint8_t row = 0; row < lcd->rows; row++) {
+			printf(" |%s|", rows[row]);
+		}
+		printf("  \n");
+		hostFailures++;
+	}
+}
+
+/**
+	* @brief	       BF
+	* @param	n			 
+	* @param	name	 
+	* @param	start	  , 
+	* @retval	None
+	*/
+static void hostReport(uint8_t n, const char *name, uint64_t start) {
+	HdSim *sim = &hostSim[n];
+	printf("%-24s  %3u,  %4u,  %3u,  %3u, CGRAM %3u,  %8.3f \n",
+				 name, sim->transactions, sim->busBytes, sim->commands,
+				 sim->dataWrites, sim->cgramWrites, (double)(hostNow - start) / 1e6);
+	if (sim->busyViolations) {
+		printf("%-24s   BF = 1: %u  FAIL\n", "", sim->busyViolations);
+		hostFailures++;
+	}
+	if (sim->setupViolations) {
+		printf("%-24s  R/W   E: %u  FAIL\n", "", sim->setupViolations);
+		hostFailures++;
+	}
+	hdSimStatsReset(sim);
+}
+
+/**
+	* @brief	    CGRAM
+	* @param	code	  ()
+	* @param	rows	 
+	* @retval	None
+	*/
+static void hostExpectGlyph(char code, const uint8_t *rows) {
+	int ok = (uint8_t)code < 8 && memcmp(&hostSim[0].cgram[(uint8_t)code * 8], rows, 8) == 0;
+	printf("%-24s  %d  %s\n", "CGRAM", code, ok ? "OK" : "FAIL");
+	if (!ok) {
+		hostFailures++;
+	}
+}
+
+int main(void) {
+	RTCTimeDate td = {58, 59, 23, 31, 12, 2099, 7};
+	static const uint8_t bell[8] = {0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00};
+	static const char *const blank[] = {"                ", "                "};
+	static const char *const time1[] = {"31/12/2099 7 OFF", "23:59:58     OFF"};
+	static const char *const time2[] = {"31/12/2099 7 OFF", "23:59:59     OFF"};
+	static const char *const time3[] = {"31/12/2099 7 ON ", "23:59:59     ON "};
+	LcdDisplay *lcd = LCD_MAIN;
+	uint64_t start;
+	
+	for (uint8_t i = 0; i < LCD_COUNT; i++) {
+		hdSimReset(&hostSim[i], I2C_SPEED_HZ);
+	}
+	
+	// 
+	start = hostNow;
+	lcdInit(lcd);
+	hostExpectScreen(0, "lcdInit", blank);
+	if (!hostSim[0].displayOn || hostSim[0].mode8bit || !hostSim[0].lines2) {
+		printf("lcdInit:    FAIL\n");
+		hostFailures++;
+	}
+#ifdef LCD_BUSY_FLAG
+	if (!lcd->busyFlagOk) {
+		printf("lcdInit:  BF    FAIL\n");
+		hostFailures++;
+	}
+#endif
+	hostReport(0, "lcdInit", start);
+	
+	//   
+	start = hostNow;
+	lcdUpdateTime(lcd, &td);
+	hostExpectScreen(0, "lcdUpdateTime", time1);
+	hostReport(0, "lcdUpdateTime", start);
+	
+	//  :   
+	start = hostNow;
+	td.seconds = 59;
+	lcdUpdateTime(lcd, &td);
+	hostExpectScreen(0, "", time2);
+	hostReport(0, "", start);
+	
+	//  :    
+	start = hostNow;
+	lcdUpdateTime(lcd, &td);
+	hostReport(0, " ", start);
+	
+	//     
+	start = hostNow;
+	hostSchedulerOn = 1;
+	hostDeviceOn = 1;
+	lcdUpdateTime(lcd, &td);
+	hostExpectScreen(0, "", time3);
+	hostReport(0, "", start);
+	
+	//  :     
+	lcdClear(lcd);
+	lcdSetCursor(lcd, 0, 0);
+	lcdPrintString(lcd, "BELL");
+	char bellCode = lcdGlyphCode(lcd, LCD_GLYPH_BELL);
+	lcdPrintChar(lcd, bellCode);
+	lcdSetCursor(lcd, 1, 0);
+	lcdPrintBar(lcd, 12, 4);
+	start = hostNow;
+	lcdFlush(lcd);
+	hostExpectGlyph(bellCode, bell);
+	hostReport(0, " ()", start);
+	
+	start = hostNow;
+	lcdClear(lcd);
+	lcdFlush(lcd);
+	lcdSetCursor(lcd, 0, 0);
+	lcdPrintString(lcd, "BELL");
+	lcdPrintGlyph(lcd, LCD_GLYPH_BELL);
+	lcdFlush(lcd);
+	if (hostSim[0].cgramWrites) {
+		printf(" ():   CGRAM  FAIL\n");
+		hostFailures++;
+	}
+	hostReport(0, " ()", start);
+	
+#if LCD_COUNT > 1
+	//   20x4    :   0x00, 0x40, 0x14, 0x54
+	static const char *const rows4[] = {
+		"ROW 0           TAIL", "ROW 1               ",
+		"ROW 2               ", "ROW 3           TAIL"
+	};
+	LcdDisplay *lcd2 = LCD_DISPLAY(1);
+	start = hostNow;
+	lcdInit(lcd2);
+	hostReport(1, "lcdInit (2)", start);
+	for (uint8_t row = 0; row < 4; row++) {
+		lcdSetCursor(lcd2, row, 0);
+		lcdPrintString(lcd2, "ROW ");
+		lcdPrintUint(lcd2, row, 1);
+	}
+	lcdSetCursor(lcd2, 0, 16);
+	lcdPrintString(lcd2, "TAIL");
+	lcdSetCursor(lcd2, 3, 16);
+	lcdPrintString(lcd2, "TAILS");					//    
+	start = hostNow;
+	lcdFlush(lcd2);
+	hostExpectScreen(1, "20x4", rows4);
+	hostReport(1, "20x4", start);
+	
+	//       
+	hostExpectScreen(0, " 0", (const char *const[]){"BELL0           ", "                "});
+#endif
+	
+	//      CGRAM: ,  
+	//  65536 ,   ,  100  
+	lcdClear(lcd);
+	lcdFlush(lcd);
+	for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+		lcd->glyphSlot[slot] = LCD_GLYPH_NONE;
+	}
+	for (uint8_t id = 0; id < LCD_GLYPH_SLOTS; id++) {
+		lcdGlyphCode(lcd, id);									//  0-7,   -  0
+	}
+	for (uint32_t i = 0; i < 65500UL; i++) {
+		lcdGlyphCode(lcd, LCD_GLYPH_SLOTS - 1);
+	}
+	lcdGlyphCode(lcd, LCD_GLYPH_SLOTS - 2);
+	for (uint32_t i = 0; i < 99; i++) {
+		lcdGlyphCode(lcd, LCD_GLYPH_SLOTS - 1);
+	}
+	char code = lcdGlyphCode(lcd, LCD_GLYPH_SLOTS);
+	int lruOk = code == 0 && lcd->glyphSlot[LCD_GLYPH_SLOTS - 2] == LCD_GLYPH_SLOTS - 2;
+	printf("%-24s  %d  %s\n", "CGRAM ()", code, lruOk ? "OK" : "FAIL");
+	if (!lruOk) {
+		hostFailures++;
+	}
+	
+	//    R/W:    
+	//  ,     
+	hdSimReset(&hostSim[0], I2C_SPEED_HZ);
+	hostSim[0].rwGrounded = 1;
+	start = hostNow;
+	lcdInit(lcd);
+#ifdef LCD_BUSY_FLAG
+	if (lcd->busyFlagOk) {
+		printf("R/W = GND:  BF   FAIL\n");
+		hostFailures++;
+	}
+#endif
+	hostReport(0, "lcdInit (R/W = GND)", start);
+	start = hostNow;
+	lcdClear(lcd);
+	lcdUpdateTime(lcd, &td);
+	hostExpectScreen(0, "R/W = GND", time3);
+	hostReport(0, "R/W = GND", start);
+	
+	printf("%s\n", hostFailures ? "" : "  ");
+	return hostFailures ? 1 : 0;
+}
@@ -0,0 +1,385 @@
+/**
+	******************************************************************************
+	* @file			rtc_host.c
+	* @brief		   rtc.c  
+	*
+	* RTCConvertToSeconds  RTCConvertFromSeconds  rtc.c ( 
+	*  )        
+	*  ,     :
+	* -    uint32_t (01.01.1970 00:00:00 -
+	*   07.02.2106 06:28:15)   ;
+	* -   1..31   1970..2105,  
+	*   (31.04, 30.02),      
+	*   :        .
+	*    :     
+	*      ( 2105).  x86   TSC,
+	*    - .   ,   Cortex-M3:
+	*      ,       .
+	*
+	*    (  RTC_test):
+	*		gcc -std=c99 -O2 -Wall -IHost -ICore Host/rtc_host.c Core/rtc.c \
+	*			-o rtc_host && ./rtc_host
+	*      ;  -DRTC_HOST_STEP=7
+	*   7-      (~5 ).
+	*   0 -   .
+	*
+	*     CP1251:     
+	* UTF-8  ./rtc_host | iconv -f cp1251.
+	******************************************************************************
+	*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+#include "rtc.h"
+#include "scheduler.h"
+#include "event.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_CLOCK_UNIT		" TSC"
+#else
+#define HOST_CLOCK_UNIT		""
+#endif
+
+#ifndef RTC_HOST_STEP
+#define RTC_HOST_STEP			1							//   
+#endif
+
+#define HOST_BENCH_REPEAT	64						//    ( )
+
+RTC_TypeDef hostRTC;
+RCC_TypeDef hostRCC;
+PWR_TypeDef hostPWR;
+BKP_TypeDef hostBKP;
+
+static int hostFailures = 0;
+static volatile uint32_t hostSink;				//   (   )
+
+/**
+	******************************************************************************
+	*											  
+	******************************************************************************
+	*/
+uint8_t eventPost(uint8_t prio, uint8_t type, int32_t param) {
+	(void)prio;
+	(void)type;
+	(void)param;
+	return 1;
+}
+
+void schedulerSetOnTime(RTCTimeDate *td) {
+	(void)td;
+}
+
+void schedulerSetOffTime(RTCTimeDate *td) {
+	(void)td;
+}
+
+/**
+	******************************************************************************
+	*						:    
+	******************************************************************************
+	*/
+__attribute__((noinline))
+static uint32_t refConvertToSeconds(RTCTimeDate *td) {
+	uint32_t totalDays = 0;
+	uint16_t year;
+	uint8_t month;
+
+	//      
+	for (year = 1970; year < td->year; year++) {
+		totalDays += RTCIsLeapYear(year) ? 366 : 365;
+	}
+
+	//       
+	const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30,
+																	31, 31, 30, 31, 30, 31};
+
+	//         
+	for (month = 1; month < td->month; month++) {
+		totalDays += daysInMonth[month - 1];
+
+		//      
+		if (month == 2 && RTCIsLeapYear(td->year)) {
+			totalDays += 1;
+		}
+	}
+
+	//     (-1, ..  1 )
+	totalDays += (td->day - 1);
+
+	uint32_t totalSeconds = totalDays * 86400UL;
+	totalSeconds += td->hours * 3600UL;
+	totalSeconds += td->minutes * 60UL;
+	totalSeconds += td->seconds;
+
+	return totalSeconds;
+}
+
+__attribute__((noinline))
+static void refConvertFromSeconds(uint32_t seconds, RTCTimeDate *td) {
+	uint32_t days, remainingSeconds;
+	uint16_t year = 1970;
+	uint8_t month;
+	uint8_t dayOfWeek;
+
+	days = seconds / 86400UL;
+	remainingSeconds = seconds % 86400UL;
+
+	//    (1  1970  )
+	dayOfWeek = (days + 4) % 7;
+	td->weekday = (dayOfWeek == 0) ? 7 : dayOfWeek;
+
+	//  
+	while (1) {
+		uint16_t daysInYear = RTCIsLeapYear(year) ? 366 : 365;
+
+		if (days < daysInYear) {
+			break;
+		}
+
+		days -= daysInYear;
+		year++;
+	}
+
+	td->year = year;
+
+	const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30,
+																	31, 31, 30, 31, 30, 31};
+
+	uint8_t daysInFeb = RTCIsLeapYear(year) ? 29 : 28;
+
+	//  
+	for (month = 1; month <= 12; month++) {
+		uint8_t daysThisMonth = (month == 2) ? daysInFeb : daysInMonth[month - 1];
+
+		if (days < daysThisMonth) {
+			break;
+		}
+
+		days -= daysThisMonth;
+	}
+
+	td->month = month;
+	td->day = days + 1;
+
+	td->hours = remainingSeconds / 3600;
+	remainingSeconds %= 3600;
+	td->minutes = remainingSeconds / 60;
+	td->seconds = remainingSeconds % 60;
+}
+
+/**
+	******************************************************************************
+	*											
+	******************************************************************************
+	* @brief	     
+	* @retval	1 - , 0 - 
+	*/
+static int hostSameDate(const RTCTimeDate *a, const RTCTimeDate *b) {
+	return a->seconds == b->seconds && a->minutes == b->minutes && a->hours == b->hours &&
+		a->day == b->day && a->month == b->month && a->year == b->year && a->weekday == b->weekday;
+}
+
+static void hostPrintDate(const char *name, const RTCTimeDate *td) {
+	printf("  %-8s %02u.%02u.%04u %02u:%02u:%02u (%u)\n", name, td->day, td->month, td->year,
+		td->hours, td->minutes, td->seconds, td->weekday);
+}
+
+/**
+	* @brief	     
+	* @param	seconds	  RTC
+	* @retval	None
+	*/
+static void hostCheckSecond(uint32_t seconds) {
+	RTCTimeDate ref, td;
+
+	refConvertFromSeconds(seconds, &ref);
+	RTCConvertFromSeconds(seconds, &td);
+	if (!hostSameDate(&ref, &td)) {
+		if (hostFailures++ < 10) {
+			printf("RTCConvertFromSeconds(%lu):\n", (unsigned long)seconds);
+			hostPrintDate("", &ref);
+			hostPrintDate("rtc.c", &td);
+		}
+		return;
+	}
+
+	uint32_t back = RTCConvertToSeconds(&td);
+	uint32_t refBack = refConvertToSeconds(&td);
+	if (back != seconds || refBack != seconds) {
+		if (hostFailures++ < 10) {
+			printf("RTCConvertToSeconds:  %lu, rtc.c %lu,  %lu\n",
+				(unsigned long)seconds, (unsigned long)back, (unsigned long)refBack);
+		}
+	}
+}
+
+/**
+	* @brief	    RTC_HOST_STEP    
+	* @retval	None
+	*/
+static void hostCheckAllSeconds(void) {
+	uint32_t seconds = 0;
+
+	do {
+		hostCheckSecond(seconds);
+		//         
+		if (RTC_HOST_STEP > 1 && seconds % 86400UL == 0 && seconds != 0) {
+			hostCheckSecond(seconds - 1);
+		}
+		if (seconds > UINT32_MAX - RTC_HOST_STEP) {
+			break;
+		}
+		seconds += RTC_HOST_STEP;
+	} while (1);
+	if (seconds != UINT32_MAX) {
+		hostCheckSecond(UINT32_MAX);
+	}
+
+	printf("%-30s  %u   %s\n", " 1970..2106", RTC_HOST_STEP, hostFailures ? "" : "OK");
+}
+
+/**
+	* @brief	 1..31  ,   
+	* @retval	None
+	*/
+static void hostCheckDayOverflow(void) {
+	int failures = 0;
+
+	for (uint16_t year = 1970; year <= 2105; year++) {
+		for (uint8_t month = 1; month <= 12; month++) {
+			for (uint8_t day = 1; day <= 31; day++) {
+				RTCTimeDate td = {59, 59, 23, day, month, year, 0};
+				uint32_t seconds = RTCConvertToSeconds(&td);
+				uint32_t ref = refConvertToSeconds(&td);
+				if (seconds != ref && failures++ < 10) {
+					printf("RTCConvertToSeconds(%02u.%02u.%04u): rtc.c %lu,  %lu\n",
+						day, month, year, (unsigned long)seconds, (unsigned long)ref);
+				}
+			}
+		}
+	}
+
+	printf("%-30s %s\n", " 1..31, 1970..2105", failures ? "" : "OK");
+	hostFailures += failures;
+}
+
+/**
+	******************************************************************************
+	*											 
+	******************************************************************************
+	*/
+static uint64_t hostClock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/*  : n     first   step  */
+typedef void (*HostBench)(uint32_t first, uint32_t step, uint32_t n);
+
+static void benchRefFrom(uint32_t first, uint32_t step, uint32_t n) {
+	RTCTimeDate td;
+	for (uint32_t i = 0; i < n; i++) {
+		refConvertFromSeconds(first + i * step, &td);
+		hostSink += td.day;
+	}
+}
+
+static void benchNewFrom(uint32_t first, uint32_t step, uint32_t n) {
+	RTCTimeDate td;
+	for (uint32_t i = 0; i < n; i++) {
+		RTCConvertFromSeconds(first + i * step, &td);
+		hostSink += td.day;
+	}
+}
+
+/*   RTCConvertToSeconds:   ,      */
+#define HOST_BENCH_DATES	49710UL
+static RTCTimeDate hostBenchDates[HOST_BENCH_DATES];
+
+static void hostBenchFillDates(uint32_t first, uint32_t step, uint32_t n) {
+	for (uint32_t i = 0; i < n; i++) {
+		RTCConvertFromSeconds(first + i * step, &hostBenchDates[i]);
+	}
+}
+
+static void benchRefTo(uint32_t first, uint32_t step, uint32_t n) {
+	for (uint32_t i = 0; i < n; i++) {
+		hostSink += refConvertToSeconds(&hostBenchDates[i]);
+	}
+}
+
+static void benchNewTo(uint32_t first, uint32_t step, uint32_t n) {
+	for (uint32_t i = 0; i < n; i++) {
+		hostSink += RTCConvertToSeconds(&hostBenchDates[i]);
+	}
+}
+
+/**
+	* @brief	  n   HOST_BENCH_REPEAT 
+	* @param	f				 
+	* @retval	   HOST_CLOCK_UNIT
+	*/
+static uint64_t hostBenchMin(HostBench f, uint32_t first, uint32_t step, uint32_t n) {
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < HOST_BENCH_REPEAT; r++) {
+		uint64_t start = hostClock();
+		f(first, step, n);
+		uint64_t spent = hostClock() - start;
+		if (spent < best) {
+			best = spent;
+		}
+	}
+	return best;
+}
+
+/**
+	* @brief	  
+	* @param	f				 
+	* @retval	    HOST_CLOCK_UNIT
+	*/
+static double hostBench(HostBench f, uint32_t first, uint32_t step, uint32_t n) {
+	hostBenchFillDates(first, step, n);
+	return (double)hostBenchMin(f, first, step, n) / n;
+}
+
+/**
+	* @brief	     rtc.c
+	* @retval	None
+	*/
+static void hostBenchAll(void) {
+	//    (  )  31   2105 (  )
+	const uint32_t allFirst = 43200UL, allStep = 86400UL, allN = HOST_BENCH_DATES;
+	const uint32_t decFirst = 4291718400UL, decStep = 86400UL, decN = 31UL;
+
+	printf("\n , %s (,  Cortex-M3):\n", HOST_CLOCK_UNIT);
+	printf("%-24s %12s %12s %12s %12s\n", "", "/", "rtc.c/", "/2105", "rtc.c/2105");
+	printf("%-24s %12.1f %12.1f %12.1f %12.1f\n", "RTCConvertFromSeconds",
+		hostBench(benchRefFrom, allFirst, allStep, allN),
+		hostBench(benchNewFrom, allFirst, allStep, allN),
+		hostBench(benchRefFrom, decFirst, decStep, decN),
+		hostBench(benchNewFrom, decFirst, decStep, decN));
+	printf("%-24s %12.1f %12.1f %12.1f %12.1f\n", "RTCConvertToSeconds",
+		hostBench(benchRefTo, allFirst, allStep, allN),
+		hostBench(benchNewTo, allFirst, allStep, allN),
+		hostBench(benchRefTo, decFirst, decStep, decN),
+		hostBench(benchNewTo, decFirst, decStep, decN));
+}
+
+int main(void) {
+	hostCheckAllSeconds();
+	hostCheckDayOverflow();
+	hostBenchAll();
+
+	printf("\n%s\n", hostFailures ? " " : "  ");
+	return hostFailures ? 1 : 0;
+}
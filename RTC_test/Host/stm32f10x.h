@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file			stm32f10x.h
+  * @brief		     lcd.c  rtc.c  
+  *
+  *   CMSIS     ( Host
+  *   -I   ).   , 
+  *  lcd.c, rtc.c    .   
+  * (__NOP)   ,    
+  * LCD .  RTC, RCC, PWR  BKP -  :
+  * rtc_host.c     ,  
+  *  .
+  ******************************************************************************
+  */
+
+#ifndef HOST_STM32F10X_H
+#define HOST_STM32F10X_H
+
+#include <stdint.h>
+
+#define __IO							volatile
+#define __STATIC_INLINE		static inline
+
+void hostIdle(void);							//      
+
+#define __NOP()						hostIdle()
+#define __DMB()						((void)0)
+
+/*   (   ) */
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) { }
+
+/* NVIC */
+typedef enum {
+	RTC_IRQn = 3
+} IRQn_Type;
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) { (void)irq; (void)priority; }
+static inline void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+
+/* ,  rtc.c */
+typedef struct {
+	__IO uint32_t CRH, CRL, PRLH, PRLL, DIVH, DIVL, CNTH, CNTL, ALRH, ALRL;
+} RTC_TypeDef;
+
+typedef struct {
+	__IO uint32_t APB1ENR, BDCR;
+} RCC_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR;
+} PWR_TypeDef;
+
+typedef struct {
+	__IO uint32_t DR1, DR2, DR3, DR4, DR5, DR6;
+} BKP_TypeDef;
+
+extern RTC_TypeDef hostRTC;
+extern RCC_TypeDef hostRCC;
+extern PWR_TypeDef hostPWR;
+extern BKP_TypeDef hostBKP;
+
+#define RTC								(&hostRTC)
+#define RCC								(&hostRCC)
+#define PWR								(&hostPWR)
+#define BKP								(&hostBKP)
+
+#define RTC_CRH_SECIE			0x0001
+#define RTC_CRH_ALRIE			0x0002
+#define RTC_CRL_SECF			0x0001
+#define RTC_CRL_ALRF			0x0002
+#define RTC_CRL_OWF				0x0004
+#define RTC_CRL_RSF				0x0008
+#define RTC_CRL_CNF				0x0010
+#define RTC_CRL_RTOFF			0x0020
+
+#define RCC_APB1ENR_BKPEN	0x08000000
+#define RCC_APB1ENR_PWREN	0x10000000
+#define RCC_BDCR_LSEON		0x00000001
+#define RCC_BDCR_LSERDY		0x00000002
+#define RCC_BDCR_RTCSEL		0x00000300
+#define RCC_BDCR_RTCSEL_LSE	0x00000100
+#define RCC_BDCR_RTCEN		0x00008000
+#define RCC_BDCR_BDRST		0x00010000
+
+#define PWR_CR_DBP				0x00000100
+
+#endif	/* HOST_STM32F10X_H */
@@ -12,6 +12,9 @@
 #include "Core/gpio.h"
 #include "Core/scheduler.h"
 #include "Core/matrix_keyboard.h"
+#include "Core/event.h"
+#include "Core/timer.h"
+#include "Core/fmt_bench.h"
 //      lcd.h
 //#include "Core/rtc.h"
 //#include "Core/i2c.h"
@@ -20,19 +23,54 @@
 
 extern RTCTimeDate currentTime;		//    
 extern uint8_t systemMode;
+extern uint8_t currentState;				//    (matrix_keyboard.c)
+extern uint8_t displayPage;					//    (matrix_keyboard.c)
 int keyPress =-1;
+static SoftTimer lcdInitTimer;				//    LCD
+static Pt lcdInitPt[LCD_COUNT];						//   
+#ifdef FMT_BENCH
+FmtBenchResult fmtBenchResult;				//   fmt  sprintf (  )
+#endif
 
+//    
+static void onKeyEvent(int32_t key);
+static void onSchedulerCheckEvent(int32_t param);
+static void onSecondEvent(int32_t param);
+static void onLcdInitTimer(void *ctx);
 
 
 int main(void) {
     
 	sysClockTo72();			//    72 
 	DWTDelay_Init();		//  DWT
+#ifdef FMT_BENCH
+	fmtBenchRun(&fmtBenchResult);	//  fmt  sprintf  
+#endif
+	SysTickDelay_Init();	//  SysTick ( 1    )
+	timerInit();				//   
+	AsyncDelay_Init();		//     TIM2
 	gpioInit();					//  GPIO
-	i2cInit();					//  I2C
-	lcdInit();					//  LCD
+	i2cInit();					//  I2C (  -  )
+	
+	//  LCD (~90 )   
+	//       .
+	//    :    
+	for (uint8_t i = 0; i < LCD_COUNT; i++) {
+		PT_INIT(&lcdInitPt[i]);
+	}
+	timerStart(&lcdInitTimer, 1, 1, onLcdInitTimer, 0);
+	onLcdInitTimer(0);
+	
+	//    (   RTC)
+	eventSetHandler(EVENT_KEY, onKeyEvent);
+	eventSetHandler(EVENT_SCHEDULER_CHECK, onSchedulerCheckEvent);
+	eventSetHandler(EVENT_RTC_SECOND, onSecondEvent);
+	
 	rtcInit();					//  RTC
-	keyboardInit();			//  
+	keyboardInit();			//       (TIM3)
+	
+	//   ,  -   RTC
+	eventPost(EVENT_PRIO_HIGH, EVENT_SCHEDULER_CHECK, 0);
 	
 
 
@@ -55,11 +93,73 @@ int main(void) {
 //			lastKeyboardUpdate = getDWTCountDelay();
 //		}
 	
-		//   
-		keyPress = getKeyPress();
-		if (keyPress != -1) {
-			keyboardProcessKey(keyPress);
+		//   ( LCD  .)
+		timerProcess();
+		
+		//      ,
+		//    -       
+		if (!eventDispatch()) {
+			eventIdle(timerNextExpiry());
+		}
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		    
+	* @param		param	 
+	* @retval		None
+	******************************************************************************
+	*/
+static void onKeyEvent(int32_t param) {
+	keyboardProcessEvents();
+	//        
+	RTCSetSecondInterrupt(currentState == 0 && displayPage == 0);
+}
+
+/**
+	******************************************************************************
+	* @brief		      (  RTC)
+	* @param		param	 
+	* @retval		None
+	******************************************************************************
+	*/
+static void onSchedulerCheckEvent(int32_t param) {
+	RTCGetTimeDate(&currentTime);	//   
+	schedulerCheck();
+}
+
+/**
+	******************************************************************************
+	* @brief		      
+	* @param		param	 
+	* @retval		None
+	******************************************************************************
+	*/
+static void onSecondEvent(int32_t param) {
+	RTCGetCachedTimeDate(&currentTime);	//     
+	if (currentState == 0 && displayPage == 0) {
+		lcdUpdateTime(LCD_MAIN, &currentTime);	//    
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief		     (  )
+	* @param		ctx		 
+	* @retval		None
+	******************************************************************************
+	*/
+static void onLcdInitTimer(void *ctx) {
+	uint8_t running = 0;
+	
+	//   ,  
+	for (uint8_t i = 0; i < LCD_COUNT; i++) {
+		if (!lcdIsReady(LCD_DISPLAY(i)) && PT_SCHEDULE(lcdInitThread(LCD_DISPLAY(i), &lcdInitPt[i]))) {
+			running = 1;
 		}
-		//delayDWT_ms(5); //   ,      / 
+	}
+	if (!running) {
+		timerStop(&lcdInitTimer);
 	}
 }
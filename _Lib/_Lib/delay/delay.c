@@ -7,10 +7,13 @@
 
 #include "delay.h"
 
-#define CYCLES_PER_US (SystemCoreClock / 1000000)	//    1
-#define CYCLES_PER_MS (SystemCoreClock / 1000)		//    1
+#define CYCLES_PER_US DELAY_CYCLES_PER_US	//    1 (  DELAY_CORE_CLOCK_HZ)
+#define CYCLES_PER_MS DELAY_CYCLES_PER_MS	//    1
+#define SYSTICK_LOAD_MAX	0x00FFFFFFUL					//   24-  SysTick
 
 #ifdef DWT_DELAY_ENABLE
+static volatile uint32_t dwtHigh = 0;		//  32    (  CYCCNT)
+static volatile uint32_t dwtLastLow = 0;	//    CYCCNT
 /**
 	******************************************************************************
 	*			     DWT (Data Watchpoint and Trace)
@@ -28,6 +31,8 @@ void DWTDelay_Init() {
 	
 	//    (CYCCNT - 32-  )
 	DWT->CYCCNT = 0;
+	dwtHigh = 0;
+	dwtLastLow = 0;
 	
 	//   :
 	//   CYCCNTENA    DWT
@@ -44,6 +49,71 @@ void DWTDelay_Init() {
 uint32_t getDWTCountDelay() {
 	return DWT->CYCCNT; //     
 }
+/**
+	******************************************************************************
+	* @brief	  64-  
+	* @note		CYCCNT   ~59.6  ( 72 ), 
+	*					      .
+	*					         -
+	*					  SysTick_Handler ( DWTExtend_Update  
+	*					 ,   RTC).
+	*					    ,   
+	*					   ,    .
+	*					   (WFI)     CYCCNT  .
+	* @param	None
+	* @retval     DWTDelay_Init
+	*/
+uint64_t getDWTCount64(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	uint32_t low = DWT->CYCCNT;
+	if (low < dwtLastLow) {
+		dwtHigh++;									//   CYCCNT
+	}
+	dwtLastLow = low;
+	uint64_t count = ((uint64_t)dwtHigh << 32) | low;
+	
+	__set_PRIMASK(primask);
+	return count;
+}
+/**
+	******************************************************************************
+	* @brief	  CYCCNT (   )
+	* @param	None
+	* @retval None
+	*/
+void DWTExtend_Update(void) {
+	(void)getDWTCount64();
+}
+/**
+	******************************************************************************
+	* @brief	   
+	* @note		cycles * 1000    ~8    72 
+	* @param	cycles	 
+	* @retval   
+	*/
+uint64_t DWTCyclesTo_ns(uint64_t cycles) {
+	return (cycles * 1000U) / CYCLES_PER_US;
+}
+/**
+	******************************************************************************
+	* @brief	   
+	* @param	cycles	 
+	* @retval   
+	*/
+uint64_t DWTCyclesTo_us(uint64_t cycles) {
+	return cycles / CYCLES_PER_US;
+}
+/**
+	******************************************************************************
+	* @brief	   
+	* @param	cycles	 
+	* @retval   
+	*/
+uint64_t DWTCyclesTo_ms(uint64_t cycles) {
+	return cycles / CYCLES_PER_MS;
+}
 /**
 	******************************************************************************
 	* @brief	     DWT
@@ -114,6 +184,18 @@ uint8_t delayDWT_nb_ms(uint32_t startTick, uint32_t ms) {
 
 	return ((getDWTCountDelay() - startTick) >= ms);
 }
+/**
+	******************************************************************************
+	* @brief	      64- 
+	* @note		   delayDWT_nb_ms     ~59.6 
+	* @param	startTick	 getDWTCount64()   
+	* @param	ms	   
+	* @retval 1 -   
+	* @retval	0 -    
+	*/
+uint8_t delayDWT_nb64_ms(uint64_t startTick, uint32_t ms) {
+	return ((getDWTCount64() - startTick) >= (uint64_t)ms * CYCLES_PER_MS);
+}
 #endif /* DWT_DELAY_ENABLE */
 
 #ifdef SYSTICK_DELAY_ENABLE
@@ -155,11 +237,15 @@ void SysTickDelay_Init(void) {
 	* @retval None
 	*/
 void SysTick_Handler(void) {
-	//   COUNTFLAG (      CTRL)
-	if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
-		//  countDelay  
-		countDelay++;
-	}
+	//  COUNTFLAG  :    CTRL
+	//  delaySysTick_Sleep,        .
+	//  countDelay  
+	countDelay++;
+#ifdef DWT_DELAY_ENABLE
+	//   CYCCNT  64-  
+	DWTExtend_Update();
+#endif
+
 }
 /**
 	******************************************************************************
@@ -177,6 +263,37 @@ uint32_t getSysTickCountDelay(void) {
 	} while (tick1 != tick2);
 	return tick1;
 }
+/**
+	******************************************************************************
+	* @brief	     SysTick ( DWT)
+	* @note		   countDelay   
+	*					   SysTick->VAL.  
+	*					  ;   SysTick  ,
+	*					     (PENDSTSET), 
+	*					,  VAL   .
+	*					COUNTFLAG   -     .
+	*					   ~71.6 .
+	* @param	None
+	* @retval     SysTickDelay_Init
+	*/
+uint32_t getSysTickTimestamp_us(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	uint32_t ms = countDelay;
+	uint32_t val = SysTick->VAL;
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+		//      : VAL     
+		val = SysTick->VAL;
+		ms++;
+	}
+	
+	__set_PRIMASK(primask);
+	
+	//     CYCLES_PER_MS - 1  0
+	uint32_t elapsed = (val < CYCLES_PER_MS) ? (CYCLES_PER_MS - 1 - val) : 0;
+	return ms * 1000 + elapsed / CYCLES_PER_US;
+}
 /**
 	******************************************************************************
 	* @brief	     SysTick
@@ -189,8 +306,11 @@ void delaySysTick_ms(uint32_t ms) {
 	//       
 	//      .
 	//        countTick
-	// (  )
-	while((getSysTickCountDelay() - startTick) < ms);
+	// (  ).
+	//    :  SysTick    
+	while((getSysTickCountDelay() - startTick) < ms) {
+		__WFI();
+	}
 }
 
 /**
@@ -208,22 +328,355 @@ uint8_t delaySysTick_nb_ms(uint32_t startTick, uint32_t ms) {
 	// (  )
 	return (getSysTickCountDelay() - startTick) >= ms;
 }
+
+/**
+	******************************************************************************
+	* @brief	   SysTick (tickless idle)
+	* @note		    (__disable_irq), 
+	*					 SysTick      .
+	*					SysTick      ms 
+	*					(  SYSTICK_LOAD_MAX , ~233   72 ),
+	*					   WFI.   (  
+	*					  ) countDelay   
+	*					 ,      
+	*					,      (
+	*					    ).
+	* @param	ms	    
+	* @retval None
+	*/
+void delaySysTick_Sleep(uint32_t ms) {
+	uint32_t maxMs = SYSTICK_LOAD_MAX / CYCLES_PER_MS;
+	if (ms > maxMs) {
+		ms = maxMs;
+	}
+	if (ms < 2) {
+		__WFI();																	//    
+		return;
+	}
+	
+	//  
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	uint32_t remain = SysTick->VAL;							//    
+	
+	//       -     
+	if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) || remain < 2) {
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return;
+	}
+	
+	//    ms    
+	uint32_t sleepCycles = remain + (ms - 1) * CYCLES_PER_MS;
+	SysTick->LOAD = sleepCycles - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	
+	__DSB();
+	__WFI();
+	__ISB();
+	
+	//      
+	uint32_t ctrl = SysTick->CTRL;								//   COUNTFLAG
+	SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+	uint32_t elapsed = (sleepCycles - 1) - SysTick->VAL;
+	uint32_t ticks, after;
+	
+	if (ctrl & SysTick_CTRL_COUNTFLAG_Msk) {
+		//   :   ,   ,
+		// elapsed -    
+		SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+		ticks = ms;
+		after = elapsed;
+	} else if (elapsed < remain) {
+		//    
+		ticks = 0;
+		after = elapsed + (CYCLES_PER_MS - remain);
+	} else {
+		//  :    
+		ticks = 1;
+		after = elapsed - remain;
+	}
+	ticks += after / CYCLES_PER_MS;
+	countDelay += ticks;
+	
+	//   -   ,    1 
+	uint32_t toNext = CYCLES_PER_MS - after % CYCLES_PER_MS;
+	SysTick->LOAD = (toNext < 2) ? 1 : (toNext - 1);
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = CYCLES_PER_MS - 1;						//      
+}
 #endif /* SYSTICK_DELAY_ENABLE */
 
+#ifdef ASYNC_DELAY_ENABLE
+/**
+	******************************************************************************
+	*			    TIM2
+	******************************************************************************
+	* TIM2    1   0  0xFFFF,  (UIF)
+	*    32 .     ,
+	*    ,    CC1
+	*    .     
+	* ,      
+	*   .     
+	*    .
+	*/
+
+/*   */
+typedef struct {
+	uint32_t deadline;													//  ,  (32- )
+	DelayCallback callback;											//  
+	void *ctx;																	//   
+	uint8_t next;																//    
+	uint8_t active;															//  
+} AsyncDelay;
+
+static AsyncDelay asyncPool[ASYNC_DELAY_POOL_SIZE];
+static uint8_t asyncHead = ASYNC_DELAY_NONE;			//  
+static volatile uint16_t asyncHigh = 0;						//  16   
+
+static uint32_t asyncNow(void);
+static void asyncArm(void);
+
+/**
+	******************************************************************************
+	* @brief	 TIM2    (1 )
+	* @param	None
+	* @retval None
+	*/
+void AsyncDelay_Init(void) {
+	RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+	
+	//    APB1:   APB1  1 -  PCLK1
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> 8;
+	uint32_t timClk = SystemCoreClock;
+	if (ppre1 & 0x4) {
+		timClk = (SystemCoreClock >> ((ppre1 & 0x3) + 1)) * 2;
+	}
+	
+	TIM2->CR1 = 0;
+	TIM2->PSC = timClk / 1000000 - 1;						// 1  = 1 
+	TIM2->ARR = 0xFFFF;
+	TIM2->CNT = 0;
+	TIM2->EGR = TIM_EGR_UG;											//  
+	TIM2->SR = 0;
+	TIM2->DIER = TIM_DIER_UIE;									//  -  
+	//     (delayAsync_us)
+	
+	for (uint8_t i = 0; i < ASYNC_DELAY_POOL_SIZE; i++) {
+		asyncPool[i].active = 0;
+	}
+	asyncHead = ASYNC_DELAY_NONE;
+	asyncHigh = 0;
+	
+	NVIC_SetPriority(TIM2_IRQn, ASYNC_DELAY_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+/**
+	******************************************************************************
+	* @brief	    
+	* @note		     TIM2   
+	*					 (,     
+	*					   )
+	* @param	us				    (  2^31)
+	* @param	callback	 
+	* @param	ctx				  
+	* @retval	  ( delayAsync_Cancel)  ASYNC_DELAY_NONE,
+	*					  ASYNC_DELAY_POOL_SIZE  
+	*/
+uint8_t delayAsync_us(uint32_t us, DelayCallback callback, void *ctx) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	//   
+	uint8_t id = 0;
+	while (id < ASYNC_DELAY_POOL_SIZE && asyncPool[id].active) {
+		id++;
+	}
+	if (id == ASYNC_DELAY_POOL_SIZE) {
+		__set_PRIMASK(primask);
+		return ASYNC_DELAY_NONE;
+	}
+	
+	//      
+	if (asyncHead == ASYNC_DELAY_NONE) {
+		TIM2->CNT = 0;
+		asyncHigh = 0;
+		TIM2->SR = 0;
+		TIM2->CR1 |= TIM_CR1_CEN;
+	}
+	
+	AsyncDelay *d = &asyncPool[id];
+	d->deadline = asyncNow() + (us ? us : 1);
+	d->callback = callback;
+	d->ctx = ctx;
+	d->active = 1;
+	
+	//       (   -
+	//    32- )
+	uint8_t *link = &asyncHead;
+	while (*link != ASYNC_DELAY_NONE &&
+				 (int32_t)(asyncPool[*link].deadline - d->deadline) <= 0) {
+		link = &asyncPool[*link].next;
+	}
+	d->next = *link;
+	*link = id;
+	
+	if (asyncHead == id) {
+		asyncArm();																//   
+	}
+	
+	__set_PRIMASK(primask);
+	return id;
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @param	id	 ,   delayAsync_us
+	* @retval 1 -  , 0 -     
+	*/
+uint8_t delayAsync_Cancel(uint8_t id) {
+	uint8_t result = 0;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	if (id < ASYNC_DELAY_POOL_SIZE && asyncPool[id].active) {
+		uint8_t *link = &asyncHead;
+		while (*link != id) {
+			link = &asyncPool[*link].next;
+		}
+		*link = asyncPool[id].next;
+		asyncPool[id].active = 0;
+		asyncArm();
+		result = 1;
+	}
+	
+	__set_PRIMASK(primask);
+	return result;
+}
+
+/**
+	******************************************************************************
+	* @brief	  TIM2
+	* @param	None
+	* @retval None
+	*/
+void TIM2_IRQHandler(void) {
+	uint16_t sr = TIM2->SR;
+	
+	if (sr & TIM_SR_UIF) {
+		TIM2->SR = (uint16_t)~TIM_SR_UIF;
+		asyncHigh++;
+	}
+	if (sr & TIM_SR_CC1IF) {
+		TIM2->SR = (uint16_t)~TIM_SR_CC1IF;
+	}
+	
+	//    .   
+	//   ,      
+	while (asyncHead != ASYNC_DELAY_NONE &&
+				 (int32_t)(asyncPool[asyncHead].deadline - asyncNow()) <= 0) {
+		AsyncDelay *d = &asyncPool[asyncHead];
+		asyncHead = d->next;
+		d->active = 0;
+		d->callback(d->ctx);
+	}
+	asyncArm();
+}
+
+/**
+	******************************************************************************
+	* @brief	  32-  
+	* @note		       TIM2
+	* @param	None
+	* @retval   AsyncDelay_Init
+	*/
+static uint32_t asyncNow(void) {
+	uint16_t high = asyncHigh;
+	uint16_t cnt = TIM2->CNT;
+	
+	//  ,    
+	if ((TIM2->SR & TIM_SR_UIF) && cnt < 0x8000) {
+		high++;
+	}
+	return ((uint32_t)high << 16) | cnt;
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @note		       TIM2
+	* @param	None
+	* @retval None
+	*/
+static void asyncArm(void) {
+	if (asyncHead == ASYNC_DELAY_NONE) {
+		//   -  
+		TIM2->CR1 &= ~TIM_CR1_CEN;
+		TIM2->DIER &= ~TIM_DIER_CC1IE;
+		TIM2->SR = 0;
+		NVIC_ClearPendingIRQ(TIM2_IRQn);
+		return;
+	}
+	
+	uint32_t deadline = asyncPool[asyncHead].deadline;
+	int32_t remain = (int32_t)(deadline - asyncNow());
+	
+	if (remain > 0xFFFF) {
+		//     -   
+		TIM2->DIER &= ~TIM_DIER_CC1IE;
+		return;
+	}
+	
+	TIM2->CCR1 = (uint16_t)deadline;
+	TIM2->SR = (uint16_t)~TIM_SR_CC1IF;
+	TIM2->DIER |= TIM_DIER_CC1IE;
+	
+	//       -    
+	if ((int32_t)(deadline - asyncNow()) <= 0) {
+		TIM2->EGR = TIM_EGR_CC1G;
+	}
+}
+#endif /* ASYNC_DELAY_ENABLE */
+
 /**
 	******************************************************************************
 	*				       
+	******************************************************************************
+	* @brief	  n   DELAY_LOOP_CYCLES 
+	* @note		   ,     
+	*					  .  n = 0   
+	* @param	n	 
+	* @retval None
+	*/
+#if defined(__CC_ARM)
+__asm void delayLoop(uint32_t n) {
+loop
+	SUBS	r0, r0, #1
+	BHI		loop
+	BX		lr
+}
+#else
+void delayLoop(uint32_t n) {
+	__asm volatile (
+		"1:	subs	%0, %0, #1	\n"
+		"		bhi		1b					\n"
+		: "+r" (n) : : "cc");
+}
+#endif
+
+#ifndef DELAY_CORE_CLOCK_HZ
+/**
 	******************************************************************************
 	* @brief	      
-	* @note		,    "n"
+	* @note		     ,   
+	*					   DELAY_CORE_CLOCK_HZ (. delay.h)
 	* @param	us	 
 	* @retval None
 	*/
 void delaySimple_us(uint32_t us) {
-	uint8_t n = 50;
-	for (uint32_t i = 0; i < us; i++) {
-		for (volatile uint32_t j = 0; j < CYCLES_PER_US/n; j++) {
-			__NOP();
-			}
-	}
+	uint32_t cycles = us * CYCLES_PER_US;
+	delayLoop((cycles > DELAY_LOOP_OVERHEAD) ? (cycles - DELAY_LOOP_OVERHEAD) / DELAY_LOOP_CYCLES : 0);
 }
+#endif
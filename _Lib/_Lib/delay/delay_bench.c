@@ -0,0 +1,504 @@
+/**
+	******************************************************************************
+	* @file		delay_bench.c
+	* @brief	    
+	*
+	*     (delayDWT_us, delaySimple_us, delaySysTick_ms)
+	*   ,    
+	*    DWT.  (  -  -
+	*    )   
+	*   .    
+	*     TIM3 (BENCH_LOAD_HZ).  SysTick 
+	*    -    delaySysTick_ms.
+	* delaySysTick_ms    WFI,        CYCCNT
+	* .      DBGMCU_CR_DBG_SLEEP
+	* (    , CYCCNT ),  -  
+	* .       .
+	*    USART1 (PA9, BENCH_BAUDRATE)   CSV.
+	*
+	*       :
+	*		gcc -DDELAY_BENCH_HOST delay_bench.c -o delay_bench && ./delay_bench
+	*       ,  -  stdout,
+	*       .
+	******************************************************************************
+	*/
+
+#include "delay_bench.h"
+#include <stdio.h>
+
+#ifdef DELAY_BENCH_HOST
+#include <stdlib.h>
+#define BENCH_CYCLES_PER_US	72U
+#define BENCH_CYCLES_PER_MS	72000U
+#else
+#include "delay.h"
+#define BENCH_CYCLES_PER_US	DELAY_CYCLES_PER_US
+#define BENCH_CYCLES_PER_MS	DELAY_CYCLES_PER_MS
+#endif
+
+/*     */
+typedef void (*BenchDelay)(uint32_t);
+
+/*      */
+typedef struct {
+	const char *name;										//   CSV
+	BenchDelay delay;										//  
+	uint16_t usPerUnit;									//     (1  1000)
+	const uint32_t *durations;					//  
+	uint8_t durationCount;							//  
+	uint16_t samples;										//   
+} BenchTarget;
+
+static uint32_t benchReadCycles(void);
+static void benchLoad(uint8_t enable);
+static uint8_t benchSleepClock(uint8_t enable);
+static void benchPuts(const char *str);
+static void benchRunTarget(const BenchTarget *target, uint8_t load, uint32_t overhead);
+static uint32_t benchMeasureOverhead(void);
+static uint32_t benchIsqrt(uint64_t value);
+
+/**
+	******************************************************************************
+	*											 (    )
+	******************************************************************************
+	* @brief	 
+	* @param	stats	
+	* @retval None
+	*/
+void benchStatsReset(BenchStats *stats) {
+	stats->count = 0;
+	stats->min = INT32_MAX;
+	stats->max = INT32_MIN;
+	stats->sum = 0;
+	stats->sumSq = 0;
+	for (uint8_t i = 0; i < BENCH_BINS; i++) {
+		stats->bins[i] = 0;
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	    
+	* @param	overshoot	  
+	* @retval 0 -  (<0), 1 - 0..7, i - [2^(i+1), 2^(i+2)),  - 
+	*/
+uint8_t benchStatsBin(int32_t overshoot) {
+	if (overshoot < 0) {
+		return 0;
+	}
+	if (overshoot < 8) {
+		return 1;
+	}
+	uint8_t log2 = 0;
+	for (uint32_t v = (uint32_t)overshoot; v > 1; v >>= 1) {
+		log2++;
+	}
+	uint8_t bin = log2 - 1;										// 8..15 -> 2, 16..31 -> 3, ...
+	return (bin < BENCH_BINS) ? bin : (BENCH_BINS - 1);
+}
+
+/**
+	******************************************************************************
+	* @brief	 
+	* @param	stats			
+	* @param	overshoot	   ( - )
+	* @retval None
+	*/
+void benchStatsAdd(BenchStats *stats, int32_t overshoot) {
+	stats->count++;
+	if (overshoot < stats->min) stats->min = overshoot;
+	if (overshoot > stats->max) stats->max = overshoot;
+	stats->sum += overshoot;
+	stats->sumSq += (uint64_t)((int64_t)overshoot * overshoot);
+	stats->bins[benchStatsBin(overshoot)]++;
+}
+
+/**
+	******************************************************************************
+	* @brief	    (   )
+	* @param	stats	
+	* @retval  
+	*/
+int32_t benchStatsMean(const BenchStats *stats) {
+	if (stats->count == 0) {
+		return 0;
+	}
+	int64_t half = (stats->sum >= 0) ? (int64_t)stats->count / 2 : -(int64_t)stats->count / 2;
+	return (int32_t)((stats->sum + half) / (int64_t)stats->count);
+}
+
+/**
+	******************************************************************************
+	* @brief	 -     
+	* @param	stats	
+	* @retval  ( )
+	*/
+uint32_t benchStatsJitter(const BenchStats *stats) {
+	if (stats->count < 2) {
+		return 0;
+	}
+	// n * sum(x^2) - (sum x)^2 = n^2 * 
+	uint64_t n = stats->count;
+	uint64_t sumAbs = (stats->sum >= 0) ? (uint64_t)stats->sum : (uint64_t)(-stats->sum);
+	uint64_t scaled = n * stats->sumSq - sumAbs * sumAbs;
+	return benchIsqrt(scaled) / (uint32_t)n;
+}
+
+/**
+	******************************************************************************
+	* @brief	  CSV
+	* @param	out		  
+	* @retval None
+	*/
+void benchStatsPrintCsvHeader(BenchPuts out) {
+	char buf[24];
+	out("func,load,requested,samples,min,max,mean,jitter,lt0,0-7");
+	for (uint8_t i = 2; i < BENCH_BINS; i++) {
+		if (i == BENCH_BINS - 1) {
+			sprintf(buf, ",%lu+", 1UL << (i + 1));
+		} else {
+			sprintf(buf, ",%lu-%lu", 1UL << (i + 1), (1UL << (i + 2)) - 1);
+		}
+		out(buf);
+	}
+	out("\r\n");
+}
+
+/**
+	******************************************************************************
+	* @brief	  CSV
+	* @param	out				  
+	* @param	name			  
+	* @param	load			1 -   
+	* @param	requested	  (  )
+	* @param	stats			
+	* @retval None
+	*/
+void benchStatsPrintCsv(BenchPuts out, const char *name, uint8_t load, uint32_t requested, const BenchStats *stats) {
+	char buf[96];
+	sprintf(buf, "%s,%u,%lu,%lu,%ld,%ld,%ld,%lu", name, load, (unsigned long)requested,
+					(unsigned long)stats->count, (long)stats->min, (long)stats->max,
+					(long)benchStatsMean(stats), (unsigned long)benchStatsJitter(stats));
+	out(buf);
+	for (uint8_t i = 0; i < BENCH_BINS; i++) {
+		sprintf(buf, ",%lu", (unsigned long)stats->bins[i]);
+		out(buf);
+	}
+	out("\r\n");
+}
+
+/**
+	******************************************************************************
+	*														
+	******************************************************************************
+	*/
+static const uint32_t benchDurationsUs[] = {1, 2, 5, 10, 20, 50, 100, 500};
+static const uint32_t benchDurationsMs[] = {1, 2, 5, 10};
+
+#ifdef DELAY_BENCH_HOST
+static uint32_t simCycles;								//  CYCCNT
+static uint8_t simLoad;										//   
+
+//   ~150   ,  
+static uint32_t simInterrupts(uint32_t cycles) {
+	uint32_t extra = 0;
+	if (simLoad && (uint32_t)(rand() % 3600) < cycles) {
+		extra = 150 + rand() % 20;
+	}
+	return extra;
+}
+static void simDelayDWT_us(uint32_t us) {
+	uint32_t cycles = us * BENCH_CYCLES_PER_US;
+	simCycles += cycles + 12 + rand() % 6 + simInterrupts(cycles);
+}
+static void simDelaySimple_us(uint32_t us) {
+	uint32_t cycles = us * BENCH_CYCLES_PER_US;
+	simCycles += cycles - 2 + rand() % 5 + simInterrupts(cycles);
+}
+static void simDelaySysTick_ms(uint32_t ms) {
+	//       1 
+	uint32_t cycles = ms * BENCH_CYCLES_PER_MS - rand() % BENCH_CYCLES_PER_MS;
+	simCycles += cycles + 40 + simInterrupts(cycles);
+}
+#define BENCH_DELAY_DWT			simDelayDWT_us
+#define BENCH_DELAY_SIMPLE	simDelaySimple_us
+#define BENCH_DELAY_SYSTICK	simDelaySysTick_ms
+#else
+// delaySimple_us   static inline -    
+static void benchDelaySimple_us(uint32_t us) {
+	delaySimple_us(us);
+}
+#define BENCH_DELAY_DWT			delayDWT_us
+#define BENCH_DELAY_SIMPLE	benchDelaySimple_us
+#define BENCH_DELAY_SYSTICK	delaySysTick_ms
+#endif
+
+static const BenchTarget benchTargets[] = {
+	{"delayDWT_us",			BENCH_DELAY_DWT,			1, benchDurationsUs, sizeof(benchDurationsUs) / sizeof(benchDurationsUs[0]), BENCH_SAMPLES},
+	{"delaySimple_us",	BENCH_DELAY_SIMPLE,		1, benchDurationsUs, sizeof(benchDurationsUs) / sizeof(benchDurationsUs[0]), BENCH_SAMPLES},
+	{"delaySysTick_ms",	BENCH_DELAY_SYSTICK,	1000, benchDurationsMs, sizeof(benchDurationsMs) / sizeof(benchDurationsMs[0]), BENCH_SAMPLES_MS},
+};
+
+/**
+	******************************************************************************
+	* @brief	  :  ,     
+	* @note		       DWTDelay_Init
+	*					 SysTickDelay_Init
+	* @param	None
+	* @retval None
+	*/
+void delayBench_Run(void) {
+	uint8_t sleepClock = benchSleepClock(1);	// CYCCNT    WFI
+	uint32_t overhead = benchMeasureOverhead();
+	char buf[48];
+
+	sprintf(buf, "# overhead,%lu\r\n", (unsigned long)overhead);
+	benchPuts(buf);
+	benchStatsPrintCsvHeader(benchPuts);
+
+	for (uint8_t load = 0; load < 2; load++) {
+		benchLoad(load);
+		for (uint8_t t = 0; t < sizeof(benchTargets) / sizeof(benchTargets[0]); t++) {
+			benchRunTarget(&benchTargets[t], load, overhead);
+		}
+	}
+	benchLoad(0);
+	benchSleepClock(sleepClock);
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @param	target		   
+	* @param	load			1 -   
+	* @param	overhead	    
+	* @retval None
+	*/
+static void benchRunTarget(const BenchTarget *target, uint8_t load, uint32_t overhead) {
+	BenchStats stats;
+
+	for (uint8_t d = 0; d < target->durationCount; d++) {
+		uint32_t requested = target->durations[d];
+		uint32_t expected = requested * target->usPerUnit * BENCH_CYCLES_PER_US;
+
+		benchStatsReset(&stats);
+		for (uint16_t s = 0; s < target->samples; s++) {
+			uint32_t start = benchReadCycles();
+			target->delay(requested);
+			uint32_t elapsed = benchReadCycles() - start;
+			benchStatsAdd(&stats, (int32_t)(elapsed - overhead - expected));
+		}
+		benchStatsPrintCsv(benchPuts, target->name, load, requested, &stats);
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	     
+	* @param	None
+	* @retval   32 , 
+	*/
+static uint32_t benchMeasureOverhead(void) {
+	uint32_t best = UINT32_MAX;
+	for (uint8_t i = 0; i < 32; i++) {
+		uint32_t start = benchReadCycles();
+		uint32_t elapsed = benchReadCycles() - start;
+		if (elapsed < best) {
+			best = elapsed;
+		}
+	}
+	return best;
+}
+
+/**
+	******************************************************************************
+	* @brief	  
+	* @param	value	
+	* @retval floor(sqrt(value))
+	*/
+static uint32_t benchIsqrt(uint64_t value) {
+	uint64_t result = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while (bit > value) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (value >= result + bit) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)result;
+}
+
+#ifndef DELAY_BENCH_HOST
+/**
+	******************************************************************************
+	*													  ()
+	******************************************************************************
+	* @brief	   
+	*/
+static uint32_t benchReadCycles(void) {
+	return DWT->CYCCNT;
+}
+
+/**
+	******************************************************************************
+	* @brief	/   TIM3
+	* @param	enable	1 - 
+	* @retval None
+	*/
+static void benchLoad(uint8_t enable) {
+	if (!enable) {
+		TIM3->CR1 &= ~TIM_CR1_CEN;
+		NVIC_DisableIRQ(TIM3_IRQn);
+		return;
+	}
+	RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+
+	//    APB1:   APB1  1 -  PCLK1
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> 8;
+	uint32_t timClk = SystemCoreClock;
+	if (ppre1 & 0x4) {
+		timClk = (SystemCoreClock >> ((ppre1 & 0x3) + 1)) * 2;
+	}
+	TIM3->PSC = timClk / 1000000 - 1;						// 1 
+	TIM3->ARR = 1000000 / BENCH_LOAD_HZ - 1;
+	TIM3->EGR = TIM_EGR_UG;
+	TIM3->SR = 0;
+	TIM3->DIER = TIM_DIER_UIE;
+	NVIC_SetPriority(TIM3_IRQn, 0x00);					//   -   
+	NVIC_EnableIRQ(TIM3_IRQn);
+	TIM3->CR1 = TIM_CR1_CEN;
+}
+
+/**
+	******************************************************************************
+	* @brief	    (DBGMCU_CR_DBG_SLEEP)
+	* @note		  CYCCNT   WFI   delaySysTick_ms
+	*					 
+	* @param	enable	1 -     WFI
+	* @retval  : 1 -  
+	*/
+static uint8_t benchSleepClock(uint8_t enable) {
+	uint8_t prev = (DBGMCU->CR & DBGMCU_CR_DBG_SLEEP) ? 1 : 0;
+	if (enable) {
+		DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP;
+	} else {
+		DBGMCU->CR &= ~DBGMCU_CR_DBG_SLEEP;
+	}
+	return prev;
+}
+
+/**
+	******************************************************************************
+	* @brief	 :     
+	*/
+void TIM3_IRQHandler(void) {
+	TIM3->SR = (uint16_t)~TIM_SR_UIF;
+	for (volatile uint32_t i = 0; i < BENCH_LOAD_WORK; i++) {
+	}
+}
+
+/**
+	******************************************************************************
+	* @brief	   USART1 (PA9),    - 
+	* @param	str	
+	* @retval None
+	*/
+static void benchPuts(const char *str) {
+	if (!(USART1->CR1 & USART_CR1_UE)) {
+		RCC->APB2ENR |= RCC_APB2ENR_IOPAEN | RCC_APB2ENR_USART1EN;
+		// PA9 - TX: Alternate Function output, push-pull, 2 MHz (CNF = 10, MODE = 10)
+		GPIOA->CRH &= ~(GPIO_CRH_CNF9 | GPIO_CRH_MODE9);
+		GPIOA->CRH |= GPIO_CRH_CNF9_1 | GPIO_CRH_MODE9_1;
+		// PCLK2 = SystemCoreClock ( APB2 = 1),   
+		USART1->BRR = (SystemCoreClock + BENCH_BAUDRATE / 2) / BENCH_BAUDRATE;
+		USART1->CR1 = USART_CR1_UE | USART_CR1_TE;
+	}
+	while (*str) {
+		while ((USART1->SR & USART_SR_TXE) == 0) {
+		}
+		USART1->DR = *str++;
+	}
+	while ((USART1->SR & USART_SR_TC) == 0) {
+	}
+}
+
+#else /* DELAY_BENCH_HOST */
+
+static uint32_t benchReadCycles(void) {
+	simCycles += 3;													//  
+	return simCycles;
+}
+
+static void benchLoad(uint8_t enable) {
+	simLoad = enable;
+}
+
+static uint8_t benchSleepClock(uint8_t enable) {
+	return 0;														//   
+}
+
+static void benchPuts(const char *str) {
+	fputs(str, stdout);
+}
+
+/*      */
+static int benchSelfCheck(void) {
+	BenchStats stats;
+	static const int32_t samples[] = {-5, 0, 7, 8, 15, 16, 100, 100000};
+	static const uint8_t bins[] = {0, 1, 1, 2, 2, 3, 5, BENCH_BINS - 1};
+	int errors = 0;
+
+	benchStatsReset(&stats);
+	for (uint8_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+		if (benchStatsBin(samples[i]) != bins[i]) {
+			printf("bin(%ld) = %u, expected %u\n", (long)samples[i], benchStatsBin(samples[i]), bins[i]);
+			errors++;
+		}
+	}
+
+	// 10, 12, 14, 16:  13,  sqrt(5) = 2.23
+	static const int32_t series[] = {10, 12, 14, 16};
+	for (uint8_t i = 0; i < 4; i++) {
+		benchStatsAdd(&stats, series[i]);
+	}
+	if (stats.count != 4 || stats.min != 10 || stats.max != 16 ||
+			benchStatsMean(&stats) != 13 || benchStatsJitter(&stats) != 2 ||
+			stats.bins[2] != 3 || stats.bins[3] != 1) {
+		printf("series stats mismatch\n");
+		errors++;
+	}
+
+	//  
+	benchStatsReset(&stats);
+	benchStatsAdd(&stats, -3);
+	benchStatsAdd(&stats, -5);
+	if (benchStatsMean(&stats) != -4 || benchStatsJitter(&stats) != 1 || stats.bins[0] != 2) {
+		printf("negative stats mismatch\n");
+		errors++;
+	}
+
+	if (benchIsqrt(0) != 0 || benchIsqrt(15) != 3 || benchIsqrt(16) != 4 ||
+			benchIsqrt(0xFFFFFFFFFFFFFFFFULL) != 0xFFFFFFFFUL) {
+		printf("isqrt mismatch\n");
+		errors++;
+	}
+	return errors;
+}
+
+int main(void) {
+	int errors = benchSelfCheck();
+	printf("# self-check: %s\n", errors ? "FAILED" : "ok");
+	if (errors) {
+		return 1;
+	}
+	srand(1);
+	delayBench_Run();
+	return 0;
+}
+#endif /* DELAY_BENCH_HOST */
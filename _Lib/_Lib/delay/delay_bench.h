@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file			delay_bench.h
+  * @brief		      
+  ******************************************************************************
+  */
+
+#ifndef DELAY_BENCH_H_
+#define DELAY_BENCH_H_
+
+#include <stdint.h>
+
+#define BENCH_SAMPLES			200					//     ()
+#define BENCH_SAMPLES_MS	20					//     ()
+#define BENCH_BINS				14					//   
+#define BENCH_LOAD_HZ			20000				//    TIM3
+#define BENCH_LOAD_WORK		20					//     
+#define BENCH_BAUDRATE		115200			//  USART1   
+
+/*      */
+typedef struct {
+	uint32_t count;										//  
+	int32_t min;											//  
+	int32_t max;											//  
+	int64_t sum;											//  
+	uint64_t sumSq;										//   
+	uint32_t bins[BENCH_BINS];				// : <0, 0-7, 8-15, 16-31, ... , >=2^BENCH_BINS
+} BenchStats;
+
+/*    */
+typedef void (*BenchPuts)(const char *str);
+
+/*   */
+void benchStatsReset(BenchStats *);										//  
+void benchStatsAdd(BenchStats *, int32_t);						//  
+uint8_t benchStatsBin(int32_t);												//   
+int32_t benchStatsMean(const BenchStats *);						//  
+uint32_t benchStatsJitter(const BenchStats *);				//   ()
+void benchStatsPrintCsvHeader(BenchPuts);							//  CSV
+void benchStatsPrintCsv(BenchPuts, const char *, uint8_t, uint32_t, const BenchStats *);	//  CSV
+
+void delayBench_Run(void);														//       USART1
+
+#endif /* DELAY_BENCH_H_ */
@@ -1,6 +1,11 @@
 #include "stm32f10x.h"                  // Device header
 #include "_Lib/delay/delay.h"
 
+//#define DELAY_BENCH_RUN		//      CSV  USART1 ()
+#ifdef DELAY_BENCH_RUN
+#include "_Lib/delay/delay_bench.h"
+#endif
+
 void pinB2init (void){	//    PORTB PIN2,    
 		RCC->APB2ENR |= RCC_APB2ENR_IOPBEN; //    B
 		
@@ -19,6 +24,10 @@ int main(void){
 	DWTDelay_Init();
 	SysTickDelay_Init();
 	
+#ifdef DELAY_BENCH_RUN
+	delayBench_Run();
+#endif
+	
 	uint32_t last_led_toggle = getDWTCountDelay();
 	while(1){
 		if(delayDWT_nb_us(last_led_toggle,1000000)){